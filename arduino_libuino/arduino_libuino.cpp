@@ -22,7 +22,8 @@
  * Arduino library to ease serial communication with computers,
  * particularly sending and receiving numeric data to/from
  * a computer via UART/serial/USB. This library will send and
- * receive 16-bit and 32-bit signed or unsigned integers.
+ * receive 16, 32 and 64-bit signed or unsigned integers and
+ * IEEE-754 floats and doubles.
  * All integers are converted to network byte order for sending
  * and back into host byte order when receiving integer data.
  * To use this library, more than likely you will also want to 
@@ -35,6 +36,110 @@
 
 #include "arduino_libuino.h"
 
+/*
+ * AVR boards have a 4-byte double, so the binary64 values exchanged with the
+ * computer are converted to and from binary32 in software there.  Values out
+ * of float range become infinity, values below it become zero, NaN stays NaN
+ * and everything else is rounded to the nearest float.  Boards with an 8-byte
+ * double send and receive its bits unchanged.
+ */
+#if __SIZEOF_DOUBLE__ == 8
+static uint64_t ino_double_bits(double d)
+{
+	ino_float64 f;
+	f.val = d;
+	return f.bits;
+}
+
+static double ino_bits_double(uint64_t bits)
+{
+	ino_float64 f;
+	f.bits = bits;
+	return f.val;
+}
+#else
+static uint64_t ino_double_bits(double d)
+{
+	ino_float32 f;			/* binary32 value being widened */
+	uint64_t sign;
+	int16_t exp;
+	uint32_t man;
+	
+	f.val = d;
+	sign = (uint64_t)(f.bits >> 31) << 63;
+	exp = (f.bits >> 23) & 0xFF;
+	man = f.bits & 0x7FFFFF;
+	
+	/* infinity and NaN keep their payload */
+	if ( exp == 0xFF ) return sign | 0x7FF0000000000000ULL | ((uint64_t)man << 29);
+	if ( exp == 0 )
+	{
+		/* signed zero */
+		if ( man == 0 ) return sign;
+		/* subnormal floats are normal doubles */
+		exp = 1;
+		while ( !(man & 0x800000) )
+		{
+			man <<= 1;
+			exp--;
+		}
+		man &= 0x7FFFFF;
+	}
+	
+	return sign | ((uint64_t)(exp - 127 + 1023) << 52) | ((uint64_t)man << 29);
+}
+
+static double ino_bits_double(uint64_t bits)
+{
+	ino_float32 f;			/* binary32 result */
+	uint32_t sign = (uint32_t)(bits >> 63) << 31;
+	int16_t exp = (bits >> 52) & 0x7FF;
+	uint64_t man = bits & 0xFFFFFFFFFFFFFULL;
+	uint64_t rem, half;
+	uint8_t shift;
+	
+	if ( exp == 0x7FF )
+	{
+		/* infinity, or a quiet NaN with as much payload as fits */
+		f.bits = sign | 0x7F800000 | ( man ? 0x400000 | (uint32_t)(man >> 29) : 0 );
+		return f.val;
+	}
+	
+	exp = exp - 1023 + 127;
+	if ( exp >= 0xFF )
+	{
+		/* too large, round to infinity */
+		f.bits = sign | 0x7F800000;
+		return f.val;
+	}
+	if ( exp > 0 )
+	{
+		shift = 29;
+	}
+	else
+	{
+		/* result is subnormal or zero */
+		if ( exp < -24 )
+		{
+			f.bits = sign;
+			return f.val;
+		}
+		man |= 0x10000000000000ULL;
+		shift = 30 - exp;
+		exp = 0;
+	}
+	
+	/* round to nearest, ties to even; a carry correctly bumps the exponent */
+	rem = man & ((1ULL << shift) - 1);
+	half = 1ULL << (shift - 1);
+	man >>= shift;
+	if ( rem > half || ( rem == half && (man & 1) ) ) man++;
+	f.bits = sign + ((uint32_t)exp << 23) + (uint32_t)man;
+	
+	return f.val;
+}
+#endif
+
 /** 
  * Read 16-bit signed integer from computer through serial port.
  * Function to read a raw signed 16-bit integer from the Serial
@@ -263,3 +368,1141 @@ ino_send_raw(uint8_t *buf, int nbytes)
 		Serial.write(buf[j]);
 }
 
+/** 
+ * Read multiple signed 16-bit integers from computer through serial port.
+ * Function to read an array of raw signed 16-bit integers from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these integers from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of int16_t.
+ * @param count The number of integers to read.
+ * @return The number of integers read.
+ * @since 0.2
+ */
+int ino_read_int16s(int16_t *buf, int count)
+{
+	uint8_t *bytes = (uint8_t *)buf;	/* raw bytes land in the caller's array */
+	uint16_t val;												/* working unsigned int */
+	int n;														/* number of whole integers read */
+	int j;
+	
+	n = Serial.readBytes((char *)bytes, count * 2) / 2;
+	/* convert each integer to host byte order in place */
+	for(j=0; j<n; j++)
+	{
+		val = (uint16_t)bytes[j*2] << 8;
+		val |= bytes[j*2+1];
+		buf[j] = (int16_t)val;
+	}
+	
+	return n;
+}
+
+/** 
+ * Read multiple unsigned 16-bit integers from computer through serial port.
+ * Function to read an array of raw unsigned 16-bit integers from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these integers from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of uint16_t.
+ * @param count The number of integers to read.
+ * @return The number of integers read.
+ * @since 0.2
+ */
+int ino_read_uint16s(uint16_t *buf, int count)
+{
+	uint8_t *bytes = (uint8_t *)buf;	/* raw bytes land in the caller's array */
+	uint16_t val;												/* working unsigned int */
+	int n;														/* number of whole integers read */
+	int j;
+	
+	n = Serial.readBytes((char *)bytes, count * 2) / 2;
+	/* convert each integer to host byte order in place */
+	for(j=0; j<n; j++)
+	{
+		val = (uint16_t)bytes[j*2] << 8;
+		val |= bytes[j*2+1];
+		buf[j] = (uint16_t)val;
+	}
+	
+	return n;
+}
+
+/** 
+ * Read multiple signed 32-bit integers from computer through serial port.
+ * Function to read an array of raw signed 32-bit integers from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these integers from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of int32_t.
+ * @param count The number of integers to read.
+ * @return The number of integers read.
+ * @since 0.2
+ */
+int ino_read_int32s(int32_t *buf, int count)
+{
+	uint8_t *bytes = (uint8_t *)buf;	/* raw bytes land in the caller's array */
+	uint32_t val;												/* working unsigned int */
+	int n;														/* number of whole integers read */
+	int j, k;
+	
+	n = Serial.readBytes((char *)bytes, count * 4) / 4;
+	/* convert each integer to host byte order in place */
+	for(j=0; j<n; j++)
+	{
+		val = 0;
+		for(k=0; k<4; k++)
+		{
+			val <<= 8;
+			val |= bytes[j*4+k];
+		}
+		buf[j] = (int32_t)val;
+	}
+	
+	return n;
+}
+
+/** 
+ * Read multiple unsigned 32-bit integers from computer through serial port.
+ * Function to read an array of raw unsigned 32-bit integers from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these integers from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of uint32_t.
+ * @param count The number of integers to read.
+ * @return The number of integers read.
+ * @since 0.2
+ */
+int ino_read_uint32s(uint32_t *buf, int count)
+{
+	uint8_t *bytes = (uint8_t *)buf;	/* raw bytes land in the caller's array */
+	uint32_t val;												/* working unsigned int */
+	int n;														/* number of whole integers read */
+	int j, k;
+	
+	n = Serial.readBytes((char *)bytes, count * 4) / 4;
+	/* convert each integer to host byte order in place */
+	for(j=0; j<n; j++)
+	{
+		val = 0;
+		for(k=0; k<4; k++)
+		{
+			val <<= 8;
+			val |= bytes[j*4+k];
+		}
+		buf[j] = (uint32_t)val;
+	}
+	
+	return n;
+}
+
+/** 
+ * Send multiple signed 16-bit integers to computer through serial port.
+ * Function to send an array of raw signed 16-bit integers across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * integers are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More than
+ * likely you will be reading these integers with a corresponding libuino.h
+ * "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of int16_t.
+ * @param count The number of integers to send.
+ * @since 0.2
+ */
+void ino_send_int16s(const int16_t *buf, int count)
+{
+	uint8_t chunk[INO_SEND_CHUNK];	/* network byte order staging buffer */
+	uint16_t val;												/* working unsigned int */
+	int j, k = 0;
+	
+	for(j=0; j<count; j++)
+	{
+		val = (uint16_t)buf[j];
+		chunk[k++] = highByte(val);
+		chunk[k++] = lowByte(val);
+		/* hand over a full chunk, or the rest after the last integer */
+		if ( k > INO_SEND_CHUNK - 2 || j == count-1 )
+		{
+			Serial.write(chunk, k);
+			k = 0;
+		}
+	}
+}
+
+/** 
+ * Send multiple unsigned 16-bit integers to computer through serial port.
+ * Function to send an array of raw unsigned 16-bit integers across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * integers are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More than
+ * likely you will be reading these integers with a corresponding libuino.h
+ * "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of uint16_t.
+ * @param count The number of integers to send.
+ * @since 0.2
+ */
+void ino_send_uint16s(const uint16_t *buf, int count)
+{
+	uint8_t chunk[INO_SEND_CHUNK];	/* network byte order staging buffer */
+	uint16_t val;												/* working unsigned int */
+	int j, k = 0;
+	
+	for(j=0; j<count; j++)
+	{
+		val = (uint16_t)buf[j];
+		chunk[k++] = highByte(val);
+		chunk[k++] = lowByte(val);
+		/* hand over a full chunk, or the rest after the last integer */
+		if ( k > INO_SEND_CHUNK - 2 || j == count-1 )
+		{
+			Serial.write(chunk, k);
+			k = 0;
+		}
+	}
+}
+
+/** 
+ * Send multiple signed 32-bit integers to computer through serial port.
+ * Function to send an array of raw signed 32-bit integers across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * integers are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More than
+ * likely you will be reading these integers with a corresponding libuino.h
+ * "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of int32_t.
+ * @param count The number of integers to send.
+ * @since 0.2
+ */
+void ino_send_int32s(const int32_t *buf, int count)
+{
+	uint8_t chunk[INO_SEND_CHUNK];	/* network byte order staging buffer */
+	uint32_t val;												/* working unsigned int */
+	int j, k = 0;
+	
+	for(j=0; j<count; j++)
+	{
+		val = (uint32_t)buf[j];
+		chunk[k++] = (val >> 24) & 0xFF;
+		chunk[k++] = (val >> 16) & 0xFF;
+		chunk[k++] = (val >> 8) & 0xFF;
+		chunk[k++] = val & 0xFF;
+		/* hand over a full chunk, or the rest after the last integer */
+		if ( k > INO_SEND_CHUNK - 4 || j == count-1 )
+		{
+			Serial.write(chunk, k);
+			k = 0;
+		}
+	}
+}
+
+/** 
+ * Send multiple unsigned 32-bit integers to computer through serial port.
+ * Function to send an array of raw unsigned 32-bit integers across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * integers are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More than
+ * likely you will be reading these integers with a corresponding libuino.h
+ * "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of uint32_t.
+ * @param count The number of integers to send.
+ * @since 0.2
+ */
+void ino_send_uint32s(const uint32_t *buf, int count)
+{
+	uint8_t chunk[INO_SEND_CHUNK];	/* network byte order staging buffer */
+	uint32_t val;												/* working unsigned int */
+	int j, k = 0;
+	
+	for(j=0; j<count; j++)
+	{
+		val = (uint32_t)buf[j];
+		chunk[k++] = (val >> 24) & 0xFF;
+		chunk[k++] = (val >> 16) & 0xFF;
+		chunk[k++] = (val >> 8) & 0xFF;
+		chunk[k++] = val & 0xFF;
+		/* hand over a full chunk, or the rest after the last integer */
+		if ( k > INO_SEND_CHUNK - 4 || j == count-1 )
+		{
+			Serial.write(chunk, k);
+			k = 0;
+		}
+	}
+}
+
+/** 
+ * Read a signed 64-bit integer from computer through serial port.
+ * Function to read a raw signed 64-bit integer from the Serial interface in
+ * network byte order (i.e., big endian). Serial interface must be
+ * initialized with Serial.begin() prior to function call. More than
+ * likely you will be sending this integer from the corresponding
+ * libuino.h "send" function from the attached computer.
+ * @return 64-bit signed integer read.
+ * @since 0.2
+ */
+int64_t ino_read_int64()
+{
+	ino_int64 i;
+	int j;
+	
+	i.unsig = 0;
+	for(j=0; j<8; j++)
+	{
+		i.unsig <<= 8;
+		i.unsig |= (uint8_t)Serial.read();
+	}
+	
+	return i.sig;
+}
+
+/** 
+ * Read an unsigned 64-bit integer from computer through serial port.
+ * Function to read a raw unsigned 64-bit integer from the Serial interface in
+ * network byte order (i.e., big endian). Serial interface must be
+ * initialized with Serial.begin() prior to function call. More than
+ * likely you will be sending this integer from the corresponding
+ * libuino.h "send" function from the attached computer.
+ * @return 64-bit unsigned integer read.
+ * @since 0.2
+ */
+uint64_t ino_read_uint64()
+{
+	ino_int64 i;
+	int j;
+	
+	i.unsig = 0;
+	for(j=0; j<8; j++)
+	{
+		i.unsig <<= 8;
+		i.unsig |= (uint8_t)Serial.read();
+	}
+	
+	return i.unsig;
+}
+
+/** 
+ * Read a float from computer through serial port.
+ * Function to read the 4-byte IEEE-754 binary32 encoding of a float
+ * from the Serial interface in network byte order (i.e., big endian).
+ * Serial interface must be initialized with Serial.begin() prior to
+ * function call. More than likely you will be sending this value
+ * from the corresponding libuino.h "send" function from the attached
+ * computer.
+ * @return float read.
+ * @since 0.2
+ */
+float ino_read_float()
+{
+	ino_float32 f;
+	
+	f.bits = ino_read_uint32();
+	
+	return f.val;
+}
+
+/** 
+ * Read a double from computer through serial port.
+ * Function to read the 8-byte IEEE-754 binary64 encoding of a double
+ * from the Serial interface in network byte order (i.e., big endian).
+ * On boards with a 4-byte double, such as AVR, the value is rounded to
+ * the nearest float.  Serial interface must be initialized with
+ * Serial.begin() prior to function call. More than likely you will be
+ * sending this value from the corresponding libuino.h "send" function
+ * from the attached computer.
+ * @return double read.
+ * @since 0.2
+ */
+double ino_read_double()
+{
+	return ino_bits_double(ino_read_uint64());
+}
+
+/** 
+ * Send a signed 64-bit integer to computer through serial port.
+ * Function to send a raw signed 64-bit integer across the Serial interface in
+ * network byte order (i.e., big endian). Serial interface must be
+ * initialized with Serial.begin() prior to function call. More than
+ * likely you will be reading this integer with a corresponding
+ * libuino.h "read" function on the attached computer.
+ * @param	 n 64-bit signed integer to send.
+ * @since 0.2
+ */
+void ino_send_int64(int64_t n)
+{
+	uint8_t buf[8];	/* network byte order bytes */
+	ino_int64 i;		/* signed to unsigned converter */
+	int j;
+	
+	i.sig = n;
+	for(j=7; j>=0; j--)
+	{
+		buf[j] = i.unsig & 0xFF;
+		i.unsig >>= 8;
+	}
+	Serial.write(buf, 8);
+}
+
+/** 
+ * Send an unsigned 64-bit integer to computer through serial port.
+ * Function to send a raw unsigned 64-bit integer across the Serial interface in
+ * network byte order (i.e., big endian). Serial interface must be
+ * initialized with Serial.begin() prior to function call. More than
+ * likely you will be reading this integer with a corresponding
+ * libuino.h "read" function on the attached computer.
+ * @param	 n 64-bit unsigned integer to send.
+ * @since 0.2
+ */
+void ino_send_uint64(uint64_t n)
+{
+	uint8_t buf[8];	/* network byte order bytes */
+	ino_int64 i;		/* signed to unsigned converter */
+	int j;
+	
+	i.unsig = n;
+	for(j=7; j>=0; j--)
+	{
+		buf[j] = i.unsig & 0xFF;
+		i.unsig >>= 8;
+	}
+	Serial.write(buf, 8);
+}
+
+/** 
+ * Send a float to computer through serial port.
+ * Function to send the 4-byte IEEE-754 binary32 encoding of a float
+ * across the Serial interface in network byte order (i.e., big endian).
+ * Serial interface must be initialized with Serial.begin() prior to
+ * function call. More than likely you will be reading this value with
+ * a corresponding libuino.h "read" function on the attached computer.
+ * @param	 x float to send.
+ * @since 0.2
+ */
+void ino_send_float(float x)
+{
+	ino_float32 f;
+	
+	f.val = x;
+	ino_send_uint32(f.bits);
+}
+
+/** 
+ * Send a double to computer through serial port.
+ * Function to send the 8-byte IEEE-754 binary64 encoding of a double
+ * across the Serial interface in network byte order (i.e., big endian).
+ * On boards with a 4-byte double, such as AVR, the value is widened to
+ * binary64 exactly.  Serial interface must be initialized with
+ * Serial.begin() prior to function call. More than likely you will be
+ * reading this value with a corresponding libuino.h "read" function on
+ * the attached computer.
+ * @param	 x double to send.
+ * @since 0.2
+ */
+void ino_send_double(double x)
+{
+	ino_send_uint64(ino_double_bits(x));
+}
+
+/** 
+ * Read multiple signed 64-bit integers from computer through serial port.
+ * Function to read an array of raw signed 64-bit integers from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these integers from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of int64_t.
+ * @param count The number of integers to read.
+ * @return The number of integers read.
+ * @since 0.2
+ */
+int ino_read_int64s(int64_t *buf, int count)
+{
+	uint8_t *bytes = (uint8_t *)buf;	/* raw bytes land in the caller's array */
+	uint64_t val;												/* working unsigned int */
+	int n;														/* number of whole integers read */
+	int j, k;
+	
+	n = Serial.readBytes((char *)bytes, count * 8) / 8;
+	/* convert each integer to host byte order in place */
+	for(j=0; j<n; j++)
+	{
+		val = 0;
+		for(k=0; k<8; k++)
+		{
+			val <<= 8;
+			val |= bytes[j*8+k];
+		}
+		buf[j] = (int64_t)val;
+	}
+	
+	return n;
+}
+
+/** 
+ * Read multiple unsigned 64-bit integers from computer through serial port.
+ * Function to read an array of raw unsigned 64-bit integers from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these integers from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of uint64_t.
+ * @param count The number of integers to read.
+ * @return The number of integers read.
+ * @since 0.2
+ */
+int ino_read_uint64s(uint64_t *buf, int count)
+{
+	uint8_t *bytes = (uint8_t *)buf;	/* raw bytes land in the caller's array */
+	uint64_t val;												/* working unsigned int */
+	int n;														/* number of whole integers read */
+	int j, k;
+	
+	n = Serial.readBytes((char *)bytes, count * 8) / 8;
+	/* convert each integer to host byte order in place */
+	for(j=0; j<n; j++)
+	{
+		val = 0;
+		for(k=0; k<8; k++)
+		{
+			val <<= 8;
+			val |= bytes[j*8+k];
+		}
+		buf[j] = (uint64_t)val;
+	}
+	
+	return n;
+}
+
+/** 
+ * Read multiple floats from computer through serial port.
+ * Function to read an array of IEEE-754 binary32 floats from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these values from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of float.
+ * @param count The number of values to read.
+ * @return The number of values read.
+ * @since 0.2
+ */
+int ino_read_floats(float *buf, int count)
+{
+	uint8_t *bytes = (uint8_t *)buf;	/* raw bytes land in the caller's array */
+	ino_float32 f;										/* bits to value converter */
+	int n;														/* number of whole values read */
+	int j, k;
+	
+	n = Serial.readBytes((char *)bytes, count * 4) / 4;
+	/* convert each value to host byte order in place */
+	for(j=0; j<n; j++)
+	{
+		f.bits = 0;
+		for(k=0; k<4; k++)
+		{
+			f.bits <<= 8;
+			f.bits |= bytes[j*4+k];
+		}
+		buf[j] = f.val;
+	}
+	
+	return n;
+}
+
+/** 
+ * Read multiple doubles from computer through serial port.
+ * Function to read an array of IEEE-754 binary64 doubles from the
+ * Serial interface in network byte order (i.e., big endian).  On boards
+ * with a 4-byte double, such as AVR, each value is rounded to the nearest
+ * float, so the bytes are read one value at a time.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these values from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of double.
+ * @param count The number of values to read.
+ * @return The number of values read.
+ * @since 0.2
+ */
+int ino_read_doubles(double *buf, int count)
+{
+	uint8_t bytes[8];	/* one value in network byte order */
+	uint64_t bits;		/* binary64 encoding */
+	int j, k;
+	
+	for(j=0; j<count; j++)
+	{
+		if ( Serial.readBytes((char *)bytes, 8) != 8 ) break;
+		bits = 0;
+		for(k=0; k<8; k++)
+		{
+			bits <<= 8;
+			bits |= bytes[k];
+		}
+		buf[j] = ino_bits_double(bits);
+	}
+	
+	return j;
+}
+
+/** 
+ * Send multiple signed 64-bit integers to computer through serial port.
+ * Function to send an array of signed 64-bit integers across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * values are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More
+ * than likely you will be reading these values with a corresponding
+ * libuino.h "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of int64_t.
+ * @param count The number of values to send.
+ * @since 0.2
+ */
+void ino_send_int64s(const int64_t *buf, int count)
+{
+	uint8_t chunk[INO_SEND_CHUNK];	/* network byte order staging buffer */
+	uint64_t val;												/* working unsigned bits */
+	int j, b, k = 0;
+	
+	for(j=0; j<count; j++)
+	{
+		val = (uint64_t)buf[j];
+		for(b=56; b>=0; b-=8)
+			chunk[k++] = (val >> b) & 0xFF;
+		/* hand over a full chunk, or the rest after the last value */
+		if ( k > INO_SEND_CHUNK - 8 || j == count-1 )
+		{
+			Serial.write(chunk, k);
+			k = 0;
+		}
+	}
+}
+
+/** 
+ * Send multiple unsigned 64-bit integers to computer through serial port.
+ * Function to send an array of unsigned 64-bit integers across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * values are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More
+ * than likely you will be reading these values with a corresponding
+ * libuino.h "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of uint64_t.
+ * @param count The number of values to send.
+ * @since 0.2
+ */
+void ino_send_uint64s(const uint64_t *buf, int count)
+{
+	uint8_t chunk[INO_SEND_CHUNK];	/* network byte order staging buffer */
+	uint64_t val;												/* working unsigned bits */
+	int j, b, k = 0;
+	
+	for(j=0; j<count; j++)
+	{
+		val = buf[j];
+		for(b=56; b>=0; b-=8)
+			chunk[k++] = (val >> b) & 0xFF;
+		/* hand over a full chunk, or the rest after the last value */
+		if ( k > INO_SEND_CHUNK - 8 || j == count-1 )
+		{
+			Serial.write(chunk, k);
+			k = 0;
+		}
+	}
+}
+
+/** 
+ * Send multiple IEEE-754 binary32 floats to computer through serial port.
+ * Function to send an array of IEEE-754 binary32 floats across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * values are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More
+ * than likely you will be reading these values with a corresponding
+ * libuino.h "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of float.
+ * @param count The number of values to send.
+ * @since 0.2
+ */
+void ino_send_floats(const float *buf, int count)
+{
+	uint8_t chunk[INO_SEND_CHUNK];	/* network byte order staging buffer */
+	ino_float32 f;										/* value to bits converter */
+	int j, k = 0;
+	
+	for(j=0; j<count; j++)
+	{
+		f.val = buf[j];
+		chunk[k++] = (f.bits >> 24) & 0xFF;
+		chunk[k++] = (f.bits >> 16) & 0xFF;
+		chunk[k++] = (f.bits >> 8) & 0xFF;
+		chunk[k++] = f.bits & 0xFF;
+		/* hand over a full chunk, or the rest after the last value */
+		if ( k > INO_SEND_CHUNK - 4 || j == count-1 )
+		{
+			Serial.write(chunk, k);
+			k = 0;
+		}
+	}
+}
+
+/** 
+ * Send multiple IEEE-754 binary64 doubles to computer through serial port.
+ * Function to send an array of IEEE-754 binary64 doubles across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * values are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call. On boards with a
+ * 4-byte double, such as AVR, each value is widened to binary64 exactly.  More
+ * than likely you will be reading these values with a corresponding
+ * libuino.h "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of double.
+ * @param count The number of values to send.
+ * @since 0.2
+ */
+void ino_send_doubles(const double *buf, int count)
+{
+	uint8_t chunk[INO_SEND_CHUNK];	/* network byte order staging buffer */
+	uint64_t val;												/* working unsigned bits */
+	int j, b, k = 0;
+	
+	for(j=0; j<count; j++)
+	{
+		val = ino_double_bits(buf[j]);
+		for(b=56; b>=0; b-=8)
+			chunk[k++] = (val >> b) & 0xFF;
+		/* hand over a full chunk, or the rest after the last value */
+		if ( k > INO_SEND_CHUNK - 8 || j == count-1 )
+		{
+			Serial.write(chunk, k);
+			k = 0;
+		}
+	}
+}
+
+/*
+ * CRC-16/CCITT lookup table, kept in flash on AVR so it costs no RAM.
+ */
+static const uint16_t ino_crc16_table[256] PROGMEM =
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+/**
+ * Update a CRC-16/CCITT (polynomial 0x1021, MSB first) with one more byte.
+ * @param crc CRC of the bytes so far.
+ * @param b Next byte.
+ * @return CRC including b.
+ * @since 0.2
+ */
+static uint16_t ino_crc16_update(uint16_t crc, uint8_t b)
+{
+	return ( crc << 8 ) ^ pgm_read_word(&ino_crc16_table[( crc >> 8 ) ^ b]);
+}
+
+/**
+ * Update a CRC-16/CCITT checksum with more bytes.
+ * @param crc INO_CRC16_INIT for the first bytes, or the previous return value.
+ * @param buf Next bytes.
+ * @param nbytes Number of bytes in buf.
+ * @return CRC of all bytes so far.
+ * @since 0.2
+ */
+uint16_t ino_crc16(uint16_t crc, const uint8_t *buf, int nbytes)
+{
+	int j;
+	
+	for(j=0; j<nbytes; j++)
+		crc = ino_crc16_update(crc, buf[j]);
+	
+	return crc;
+}
+
+/**
+ * SLIP-escape one byte into the send chunk, handing a full chunk to Serial.write().
+ * @param chunk Staging buffer of INO_SEND_CHUNK bytes.
+ * @param k Number of bytes in chunk, updated.
+ * @param b Byte to send.
+ * @since 0.2
+ */
+static void ino_frame_put(uint8_t *chunk, int *k, uint8_t b)
+{
+	if ( *k > INO_SEND_CHUNK - 2 )
+	{
+		Serial.write(chunk, *k);
+		*k = 0;
+	}
+	if ( b == INO_FRAME_END )
+	{
+		chunk[(*k)++] = INO_FRAME_ESC;
+		chunk[(*k)++] = INO_FRAME_ESC_END;
+	}
+	else if ( b == INO_FRAME_ESC )
+	{
+		chunk[(*k)++] = INO_FRAME_ESC;
+		chunk[(*k)++] = INO_FRAME_ESC_ESC;
+	}
+	else
+		chunk[(*k)++] = b;
+}
+
+/**
+ * Send a frame of bytes to the computer with framing and a checksum.
+ * The frame goes out as an INO_FRAME_END byte, the 16-bit payload length,
+ * the payload and a CRC-16/CCITT of length and payload, both fields in
+ * network byte order, SLIP-escaped so that INO_FRAME_END only occurs between
+ * frames, followed by another INO_FRAME_END byte.  Read the frames with
+ * ino_read_frame() in libuino.h on the attached computer.  Empty frames
+ * are not sent, as the readers on both sides report a timeout with size 0.
+ * @param buf Payload to send.
+ * @param nbytes Number of payload bytes, 1 to 65535.
+ * @since 0.2
+ */
+void ino_send_frame(const uint8_t *buf, int nbytes)
+{
+	uint8_t chunk[INO_SEND_CHUNK];	/* escaped staging buffer */
+	uint16_t crc = INO_CRC16_INIT;
+	int j, k = 0;
+	
+	if ( nbytes < 1 || nbytes > 0xFFFF ) return;
+	chunk[k++] = INO_FRAME_END;
+	crc = ino_crc16_update(crc, highByte((uint16_t)nbytes));
+	ino_frame_put(chunk, &k, highByte((uint16_t)nbytes));
+	crc = ino_crc16_update(crc, lowByte((uint16_t)nbytes));
+	ino_frame_put(chunk, &k, lowByte((uint16_t)nbytes));
+	for(j=0; j<nbytes; j++)
+	{
+		crc = ino_crc16_update(crc, buf[j]);
+		ino_frame_put(chunk, &k, buf[j]);
+	}
+	ino_frame_put(chunk, &k, highByte(crc));
+	ino_frame_put(chunk, &k, lowByte(crc));
+	if ( k == INO_SEND_CHUNK )
+	{
+		Serial.write(chunk, k);
+		k = 0;
+	}
+	chunk[k++] = INO_FRAME_END;
+	Serial.write(chunk, k);
+}
+
+/**
+ * Read the next valid frame sent by ino_send_frame() in libuino.h.
+ * The bytes are unescaped as they arrive and checked against the length and
+ * CRC.  A damaged frame, an empty one, or one larger than max_bytes, is
+ * skipped and reading resynchronizes at the next end byte.
+ * @param buf Destination for the payload.
+ * @param max_bytes Capacity of buf.
+ * @return Payload size, or 0 if the Serial timeout expired first.
+ * @since 0.2
+ */
+int ino_read_frame(uint8_t *buf, int max_bytes)
+{
+	uint8_t b;
+	uint16_t size = 0;			/* payload length field */
+	uint16_t crc = INO_CRC16_INIT;	/* CRC of the bytes received */
+	uint16_t sum = 0;				/* CRC field */
+	uint32_t pos = 0;				/* unescaped bytes received in this frame */
+	bool esc = false;				/* previous byte was INO_FRAME_ESC */
+	bool bad = false;				/* frame is damaged, skip to its end */
+	
+	while ( Serial.readBytes((char *)&b, 1) == 1 )
+	{
+		if ( b == INO_FRAME_END )
+		{
+			/* empty frames are never sent, a size of 0 means a timeout */
+			if ( size > 0 && !bad && !esc && pos == (uint32_t)size + 4 && crc == sum ) return size;
+			/* start over at the next frame */
+			size = 0;
+			crc = INO_CRC16_INIT;
+			sum = 0;
+			pos = 0;
+			esc = bad = false;
+			continue;
+		}
+		if ( bad ) continue;
+		if ( esc )
+		{
+			esc = false;
+			if ( b == INO_FRAME_ESC_END ) b = INO_FRAME_END;
+			else if ( b == INO_FRAME_ESC_ESC ) b = INO_FRAME_ESC;
+			else
+			{
+				bad = true;
+				continue;
+			}
+		}
+		else if ( b == INO_FRAME_ESC )
+		{
+			esc = true;
+			continue;
+		}
+		
+		if ( pos < 2 )
+		{
+			size = ( size << 8 ) | b;
+			crc = ino_crc16_update(crc, b);
+			if ( pos == 1 && size > max_bytes ) bad = true;
+		}
+		else if ( pos < (uint32_t)size + 2 )
+		{
+			buf[pos - 2] = b;
+			crc = ino_crc16_update(crc, b);
+		}
+		else if ( pos < (uint32_t)size + 4 )
+			sum = ( sum << 8 ) | b;
+		else
+			bad = true;
+		pos++;
+	}
+	
+	return 0;
+}
+
+/**
+ * Write a zigzag difference as a varint of 7 bits per byte, low bits first.
+ * @param dst Destination with room for 5 bytes.
+ * @param z Zigzag mapped difference.
+ * @return Number of bytes written.
+ * @since 0.2
+ */
+static int ino_put_varint(uint8_t *dst, uint32_t z)
+{
+	int k = 0;
+	
+	while ( z >= 0x80 )
+	{
+		dst[k++] = (uint8_t)z | 0x80;
+		z >>= 7;
+	}
+	dst[k++] = (uint8_t)z;
+	
+	return k;
+}
+
+/**
+ * Zigzag map the wrapped difference between two 16-bit samples.
+ * @since 0.2
+ */
+static uint16_t ino_zigzag16(int16_t cur, int16_t prev)
+{
+	uint16_t d = (uint16_t)cur - (uint16_t)prev;
+	return (uint16_t)( d << 1 ) ^ (uint16_t)( 0 - ( d >> 15 ) );
+}
+
+/**
+ * Zigzag map the wrapped difference between two 32-bit samples.
+ * @since 0.2
+ */
+static uint32_t ino_zigzag32(int32_t cur, int32_t prev)
+{
+	uint32_t d = (uint32_t)cur - (uint32_t)prev;
+	return ( d << 1 ) ^ ( 0 - ( d >> 31 ) );
+}
+
+/**
+ * Encode signed 16-bit integers as a delta stream.
+ * @param dst Destination with room for 3 bytes per integer.
+ * @param buf Pointer to the beginning of an array of int16_t.
+ * @param count The number of integers to encode.
+ * @return Number of bytes written to dst.
+ * @since 0.2
+ */
+int ino_encode_delta_int16s(uint8_t *dst, const int16_t *buf, int count)
+{
+	int16_t prev = 0;
+	int j, k = 0;
+	
+	for(j=0; j<count; j++)
+	{
+		k += ino_put_varint(dst + k, ino_zigzag16(buf[j], prev));
+		prev = buf[j];
+	}
+	
+	return k;
+}
+
+/**
+ * Encode signed 32-bit integers as a delta stream.
+ * @param dst Destination with room for 5 bytes per integer.
+ * @param buf Pointer to the beginning of an array of int32_t.
+ * @param count The number of integers to encode.
+ * @return Number of bytes written to dst.
+ * @since 0.2
+ */
+int ino_encode_delta_int32s(uint8_t *dst, const int32_t *buf, int count)
+{
+	int32_t prev = 0;
+	int j, k = 0;
+	
+	for(j=0; j<count; j++)
+	{
+		k += ino_put_varint(dst + k, ino_zigzag32(buf[j], prev));
+		prev = buf[j];
+	}
+	
+	return k;
+}
+
+/** 
+ * Send multiple signed 16-bit integers to computer as a delta stream.
+ * Each integer goes out as its difference from the previous one, zigzag
+ * mapped and written as a varint, staged INO_SEND_CHUNK bytes at a time.
+ * @param buf Pointer to the beginning of an array of int16_t.
+ * @param count The number of integers to send.
+ * @since 0.2
+ */
+void ino_send_delta_int16s(const int16_t *buf, int count)
+{
+	uint8_t chunk[INO_SEND_CHUNK];	/* varint staging buffer */
+	int16_t prev = 0;
+	int j, k = 0;
+	
+	for(j=0; j<count; j++)
+	{
+		k += ino_put_varint(chunk + k, ino_zigzag16(buf[j], prev));
+		prev = buf[j];
+		/* hand over a full chunk, or the rest after the last integer */
+		if ( k > INO_SEND_CHUNK - 3 || j == count-1 )
+		{
+			Serial.write(chunk, k);
+			k = 0;
+		}
+	}
+}
+
+/** 
+ * Send multiple signed 32-bit integers to computer as a delta stream.
+ * Each integer goes out as its difference from the previous one, zigzag
+ * mapped and written as a varint, staged INO_SEND_CHUNK bytes at a time.
+ * @param buf Pointer to the beginning of an array of int32_t.
+ * @param count The number of integers to send.
+ * @since 0.2
+ */
+void ino_send_delta_int32s(const int32_t *buf, int count)
+{
+	uint8_t chunk[INO_SEND_CHUNK];	/* varint staging buffer */
+	int32_t prev = 0;
+	int j, k = 0;
+	
+	for(j=0; j<count; j++)
+	{
+		k += ino_put_varint(chunk + k, ino_zigzag32(buf[j], prev));
+		prev = buf[j];
+		/* hand over a full chunk, or the rest after the last integer */
+		if ( k > INO_SEND_CHUNK - 5 || j == count-1 )
+		{
+			Serial.write(chunk, k);
+			k = 0;
+		}
+	}
+}
+
+/**
+ * Pack unsigned integers to bits width, most significant bit first.
+ * @param dst Destination with room for INO_PACKED_SIZE(count, bits) bytes.
+ * @param buf Pointer to the beginning of an array of uint16_t.
+ * @param count The number of integers to pack.
+ * @param bits Width of each integer, 1 to 16.
+ * @return Number of bytes written to dst.
+ * @since 0.2
+ */
+int ino_pack_uint16s(uint8_t *dst, const uint16_t *buf, int count, int bits)
+{
+	uint32_t acc = 0;												/* pending bits, newest lowest */
+	uint16_t mask;													/* low bits of each integer */
+	int nbits = 0;													/* number of pending bits */
+	int j, k = 0;
+	
+	if ( bits < 1 || bits > 16 ) return 0;
+	mask = 0xFFFF >> ( 16 - bits );
+	for(j=0; j<count; j++)
+	{
+		acc = ( acc << bits ) | ( buf[j] & mask );
+		nbits += bits;
+		while ( nbits >= 8 )
+		{
+			nbits -= 8;
+			dst[k++] = (uint8_t)( acc >> nbits );
+		}
+	}
+	/* pad the last byte with zero bits */
+	if ( nbits > 0 ) dst[k++] = (uint8_t)( acc << ( 8 - nbits ) );
+	
+	return k;
+}
+
+/** 
+ * Send multiple unsigned integers to computer bit-packed to bits width.
+ * Packs INO_SEND_CHUNK bytes at a time, always a whole number of bytes
+ * and integers per chunk, so any number of integers can be sent from a
+ * small buffer.
+ * @param buf Pointer to the beginning of an array of uint16_t.
+ * @param count The number of integers to send.
+ * @param bits Width of each integer, 1 to 16.
+ * @since 0.2
+ */
+void ino_send_packed(const uint16_t *buf, int count, int bits)
+{
+	uint8_t chunk[INO_SEND_CHUNK];	/* packed staging buffer */
+	int step;												/* integers per chunk */
+	int j, n;
+	
+	if ( bits < 1 || bits > 16 ) return;
+	/* a multiple of 8 integers fills whole bytes */
+	step = ( INO_SEND_CHUNK * 8 / bits ) & ~7;
+	for(j=0; j<count; j+=step)
+	{
+		n = ino_pack_uint16s(chunk, buf + j, count - j < step ? count - j : step, bits);
+		Serial.write(chunk, n);
+	}
+}
+
+/**
+ * Tell the computer that the sketch is up and ready to communicate.
+ * @since 0.2
+ */
+void ino_send_ready()
+{
+	Serial.write((uint8_t)INO_READY_BYTE);
+}
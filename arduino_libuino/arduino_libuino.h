@@ -22,7 +22,8 @@
  * Arduino library to ease serial communication with computers,
  * particularly sending and receiving numeric data to/from
  * a computer via UART/serial/USB. This library will send and
- * receive 16-bit and 32-bit signed or unsigned integers.
+ * receive 16, 32 and 64-bit signed or unsigned integers and
+ * IEEE-754 floats and doubles.
  * All integers are converted to network byte order for sending
  * and back into host byte order when receiving integer data.
  * To use this library, more than likely you will also want to 
@@ -39,6 +40,16 @@
 #include "Arduino.h"
 #include "stdint.h"
 
+/* CONSTANTS */
+#define INO_SEND_CHUNK 32
+#define INO_FRAME_END 0xC0
+#define INO_FRAME_ESC 0xDB
+#define INO_FRAME_ESC_END 0xDC
+#define INO_FRAME_ESC_ESC 0xDD
+#define INO_CRC16_INIT 0xFFFF
+#define INO_READY_BYTE 0x06
+#define INO_PACKED_SIZE(count, bits) ( ( (long)(count) * (bits) + 7 ) / 8 )
+
 /**
  * Data type for converting between signed, unsigned, and byte array representations of 16-bit integers.
  * @since 0.1
@@ -63,6 +74,45 @@ typedef union _ino_int32
 }
 ino_int32;
 
+/**
+ * Data type for converting between signed, unsigned, and byte array representations of 64-bit integers.
+ * @since 0.2
+ */
+typedef union _ino_int64
+{
+	int64_t sig;			/**< signed integer */
+	uint64_t unsig;		/**< unsigned integer */
+	char bytes[8];		/**< byte array */
+}
+ino_int64;
+
+/**
+ * Data type for converting between a float and its IEEE-754 binary32 bits.
+ * @since 0.2
+ */
+typedef union _ino_float32
+{
+	float val;				/**< floating point value */
+	uint32_t bits;		/**< binary32 encoding */
+	char bytes[4];		/**< byte array */
+}
+ino_float32;
+
+#if __SIZEOF_DOUBLE__ == 8
+/**
+ * Data type for converting between a double and its IEEE-754 binary64 bits.
+ * Only defined where double is 8 bytes; on AVR double is a float.
+ * @since 0.2
+ */
+typedef union _ino_float64
+{
+	double val;				/**< floating point value */
+	uint64_t bits;		/**< binary64 encoding */
+	char bytes[8];		/**< byte array */
+}
+ino_float64;
+#endif
+
 /** 
  * Read 16-bit signed integer from computer through serial port.
  * Function to read a raw signed 16-bit integer from the Serial
@@ -187,4 +237,481 @@ void ino_read_raw(uint8_t *buf, int nbytes);
  */
 void ino_send_raw(uint8_t *buf, int nbytes);
 
+/** 
+ * Read multiple signed 16-bit integers from computer through serial port.
+ * Function to read an array of raw signed 16-bit integers from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these integers from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of int16_t.
+ * @param count The number of integers to read.
+ * @return The number of integers read.
+ * @since 0.2
+ */
+int ino_read_int16s(int16_t *buf, int count);
+
+/** 
+ * Read multiple unsigned 16-bit integers from computer through serial port.
+ * Function to read an array of raw unsigned 16-bit integers from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these integers from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of uint16_t.
+ * @param count The number of integers to read.
+ * @return The number of integers read.
+ * @since 0.2
+ */
+int ino_read_uint16s(uint16_t *buf, int count);
+
+/** 
+ * Read multiple signed 32-bit integers from computer through serial port.
+ * Function to read an array of raw signed 32-bit integers from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these integers from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of int32_t.
+ * @param count The number of integers to read.
+ * @return The number of integers read.
+ * @since 0.2
+ */
+int ino_read_int32s(int32_t *buf, int count);
+
+/** 
+ * Read multiple unsigned 32-bit integers from computer through serial port.
+ * Function to read an array of raw unsigned 32-bit integers from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these integers from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of uint32_t.
+ * @param count The number of integers to read.
+ * @return The number of integers read.
+ * @since 0.2
+ */
+int ino_read_uint32s(uint32_t *buf, int count);
+
+/** 
+ * Send multiple signed 16-bit integers to computer through serial port.
+ * Function to send an array of raw signed 16-bit integers across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * integers are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More than
+ * likely you will be reading these integers with a corresponding libuino.h
+ * "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of int16_t.
+ * @param count The number of integers to send.
+ * @since 0.2
+ */
+void ino_send_int16s(const int16_t *buf, int count);
+
+/** 
+ * Send multiple unsigned 16-bit integers to computer through serial port.
+ * Function to send an array of raw unsigned 16-bit integers across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * integers are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More than
+ * likely you will be reading these integers with a corresponding libuino.h
+ * "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of uint16_t.
+ * @param count The number of integers to send.
+ * @since 0.2
+ */
+void ino_send_uint16s(const uint16_t *buf, int count);
+
+/** 
+ * Send multiple signed 32-bit integers to computer through serial port.
+ * Function to send an array of raw signed 32-bit integers across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * integers are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More than
+ * likely you will be reading these integers with a corresponding libuino.h
+ * "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of int32_t.
+ * @param count The number of integers to send.
+ * @since 0.2
+ */
+void ino_send_int32s(const int32_t *buf, int count);
+
+/** 
+ * Send multiple unsigned 32-bit integers to computer through serial port.
+ * Function to send an array of raw unsigned 32-bit integers across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * integers are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More than
+ * likely you will be reading these integers with a corresponding libuino.h
+ * "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of uint32_t.
+ * @param count The number of integers to send.
+ * @since 0.2
+ */
+void ino_send_uint32s(const uint32_t *buf, int count);
+
+/** 
+ * Read a signed 64-bit integer from computer through serial port.
+ * Function to read a raw signed 64-bit integer from the Serial interface in
+ * network byte order (i.e., big endian). Serial interface must be
+ * initialized with Serial.begin() prior to function call. More than
+ * likely you will be sending this integer from the corresponding
+ * libuino.h "send" function from the attached computer.
+ * @return 64-bit signed integer read.
+ * @since 0.2
+ */
+int64_t ino_read_int64();
+
+/** 
+ * Read an unsigned 64-bit integer from computer through serial port.
+ * Function to read a raw unsigned 64-bit integer from the Serial interface in
+ * network byte order (i.e., big endian). Serial interface must be
+ * initialized with Serial.begin() prior to function call. More than
+ * likely you will be sending this integer from the corresponding
+ * libuino.h "send" function from the attached computer.
+ * @return 64-bit unsigned integer read.
+ * @since 0.2
+ */
+uint64_t ino_read_uint64();
+
+/** 
+ * Read a float from computer through serial port.
+ * Function to read the 4-byte IEEE-754 binary32 encoding of a float
+ * from the Serial interface in network byte order (i.e., big endian).
+ * Serial interface must be initialized with Serial.begin() prior to
+ * function call. More than likely you will be sending this value
+ * from the corresponding libuino.h "send" function from the attached
+ * computer.
+ * @return float read.
+ * @since 0.2
+ */
+float ino_read_float();
+
+/** 
+ * Read a double from computer through serial port.
+ * Function to read the 8-byte IEEE-754 binary64 encoding of a double
+ * from the Serial interface in network byte order (i.e., big endian).
+ * On boards with a 4-byte double, such as AVR, the value is rounded to
+ * the nearest float.  Serial interface must be initialized with
+ * Serial.begin() prior to function call. More than likely you will be
+ * sending this value from the corresponding libuino.h "send" function
+ * from the attached computer.
+ * @return double read.
+ * @since 0.2
+ */
+double ino_read_double();
+
+/** 
+ * Send a signed 64-bit integer to computer through serial port.
+ * Function to send a raw signed 64-bit integer across the Serial interface in
+ * network byte order (i.e., big endian). Serial interface must be
+ * initialized with Serial.begin() prior to function call. More than
+ * likely you will be reading this integer with a corresponding
+ * libuino.h "read" function on the attached computer.
+ * @param	 n 64-bit signed integer to send.
+ * @since 0.2
+ */
+void ino_send_int64(int64_t n);
+
+/** 
+ * Send an unsigned 64-bit integer to computer through serial port.
+ * Function to send a raw unsigned 64-bit integer across the Serial interface in
+ * network byte order (i.e., big endian). Serial interface must be
+ * initialized with Serial.begin() prior to function call. More than
+ * likely you will be reading this integer with a corresponding
+ * libuino.h "read" function on the attached computer.
+ * @param	 n 64-bit unsigned integer to send.
+ * @since 0.2
+ */
+void ino_send_uint64(uint64_t n);
+
+/** 
+ * Send a float to computer through serial port.
+ * Function to send the 4-byte IEEE-754 binary32 encoding of a float
+ * across the Serial interface in network byte order (i.e., big endian).
+ * Serial interface must be initialized with Serial.begin() prior to
+ * function call. More than likely you will be reading this value with
+ * a corresponding libuino.h "read" function on the attached computer.
+ * @param	 x float to send.
+ * @since 0.2
+ */
+void ino_send_float(float x);
+
+/** 
+ * Send a double to computer through serial port.
+ * Function to send the 8-byte IEEE-754 binary64 encoding of a double
+ * across the Serial interface in network byte order (i.e., big endian).
+ * On boards with a 4-byte double, such as AVR, the value is widened to
+ * binary64 exactly.  Serial interface must be initialized with
+ * Serial.begin() prior to function call. More than likely you will be
+ * reading this value with a corresponding libuino.h "read" function on
+ * the attached computer.
+ * @param	 x double to send.
+ * @since 0.2
+ */
+void ino_send_double(double x);
+
+/** 
+ * Read multiple signed 64-bit integers from computer through serial port.
+ * Function to read an array of raw signed 64-bit integers from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these integers from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of int64_t.
+ * @param count The number of integers to read.
+ * @return The number of integers read.
+ * @since 0.2
+ */
+int ino_read_int64s(int64_t *buf, int count);
+
+/** 
+ * Read multiple unsigned 64-bit integers from computer through serial port.
+ * Function to read an array of raw unsigned 64-bit integers from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these integers from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of uint64_t.
+ * @param count The number of integers to read.
+ * @return The number of integers read.
+ * @since 0.2
+ */
+int ino_read_uint64s(uint64_t *buf, int count);
+
+/** 
+ * Read multiple floats from computer through serial port.
+ * Function to read an array of IEEE-754 binary32 floats from the
+ * Serial interface in network byte order (i.e., big endian).  The bytes
+ * are read straight into buf and converted to host byte order in place,
+ * so no extra RAM is needed however long the array.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these values from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of float.
+ * @param count The number of values to read.
+ * @return The number of values read.
+ * @since 0.2
+ */
+int ino_read_floats(float *buf, int count);
+
+/** 
+ * Read multiple doubles from computer through serial port.
+ * Function to read an array of IEEE-754 binary64 doubles from the
+ * Serial interface in network byte order (i.e., big endian).  On boards
+ * with a 4-byte double, such as AVR, each value is rounded to the nearest
+ * float, so the bytes are read one value at a time.  Waits for the bytes
+ * up to the Serial timeout (see Serial.setTimeout()).  More than likely
+ * you will be sending these values from the corresponding libuino.h
+ * "send" function from the attached computer.
+ * @param buf Pointer to the beginning of an array of double.
+ * @param count The number of values to read.
+ * @return The number of values read.
+ * @since 0.2
+ */
+int ino_read_doubles(double *buf, int count);
+
+/** 
+ * Send multiple signed 64-bit integers to computer through serial port.
+ * Function to send an array of signed 64-bit integers across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * values are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More
+ * than likely you will be reading these values with a corresponding
+ * libuino.h "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of int64_t.
+ * @param count The number of values to send.
+ * @since 0.2
+ */
+void ino_send_int64s(const int64_t *buf, int count);
+
+/** 
+ * Send multiple unsigned 64-bit integers to computer through serial port.
+ * Function to send an array of unsigned 64-bit integers across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * values are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More
+ * than likely you will be reading these values with a corresponding
+ * libuino.h "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of uint64_t.
+ * @param count The number of values to send.
+ * @since 0.2
+ */
+void ino_send_uint64s(const uint64_t *buf, int count);
+
+/** 
+ * Send multiple IEEE-754 binary32 floats to computer through serial port.
+ * Function to send an array of IEEE-754 binary32 floats across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * values are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call.  More
+ * than likely you will be reading these values with a corresponding
+ * libuino.h "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of float.
+ * @param count The number of values to send.
+ * @since 0.2
+ */
+void ino_send_floats(const float *buf, int count);
+
+/** 
+ * Send multiple IEEE-754 binary64 doubles to computer through serial port.
+ * Function to send an array of IEEE-754 binary64 doubles across
+ * the Serial interface in network byte order (i.e., big endian).  The
+ * values are converted into a small buffer and handed to Serial.write()
+ * INO_SEND_CHUNK bytes at a time rather than one byte per call. On boards with a
+ * 4-byte double, such as AVR, each value is widened to binary64 exactly.  More
+ * than likely you will be reading these values with a corresponding
+ * libuino.h "read" function on the attached computer.
+ * @param buf Pointer to the beginning of an array of double.
+ * @param count The number of values to send.
+ * @since 0.2
+ */
+void ino_send_doubles(const double *buf, int count);
+
+
+/**
+ * Update a CRC-16/CCITT checksum (polynomial 0x1021, MSB first) with more bytes.
+ * Pass INO_CRC16_INIT with the first bytes and the previous return value with
+ * each further piece, so data can be checked while it streams in.  Uses a 256
+ * entry table kept in flash, one lookup per byte.  Gives the same result as
+ * ino_crc16() in libuino.h on the attached computer.
+ * @param crc INO_CRC16_INIT for the first bytes, or the previous return value.
+ * @param buf Next bytes.
+ * @param nbytes Number of bytes in buf.
+ * @return CRC of all bytes so far.
+ * @since 0.2
+ */
+uint16_t ino_crc16(uint16_t crc, const uint8_t *buf, int nbytes);
+
+/**
+ * Send a frame of bytes to the computer with framing and a checksum.
+ * The frame goes out as an INO_FRAME_END byte, the 16-bit payload length,
+ * the payload and a CRC-16/CCITT of length and payload, both fields in
+ * network byte order, SLIP-escaped so that INO_FRAME_END only occurs between
+ * frames, followed by another INO_FRAME_END byte.  The bytes are escaped on
+ * the fly into a small buffer, so no RAM is needed for a copy of the frame.
+ * If a byte is lost or corrupted on the way, the computer drops that one
+ * frame and picks up again at the next.  Read the frames with ino_read_frame()
+ * in libuino.h on the attached computer.  Empty frames are not sent.
+ * @param buf Payload to send.
+ * @param nbytes Number of payload bytes, 1 to 65535.
+ * @since 0.2
+ */
+void ino_send_frame(const uint8_t *buf, int nbytes);
+
+/**
+ * Read the next valid frame sent by ino_send_frame() in libuino.h.
+ * The bytes are unescaped as they arrive and checked against the length and
+ * CRC.  A damaged frame, an empty one, or one larger than max_bytes, is
+ * skipped and reading resynchronizes at the next end byte.  Waits for each
+ * byte up to the Serial timeout (see Serial.setTimeout()).
+ * @param buf Destination for the payload.
+ * @param max_bytes Capacity of buf.
+ * @return Payload size, or 0 if the Serial timeout expired first.
+ * @since 0.2
+ */
+int ino_read_frame(uint8_t *buf, int max_bytes);
+
+
+/** 
+ * Send multiple signed 16-bit integers to computer as a delta stream.
+ * Function to send an array of signed 16-bit integers, each as its
+ * difference from the previous one (the first from zero), zigzag mapped so
+ * that small negative differences stay small and written as a varint of 7
+ * bits per byte.  A slowly changing ADC reading then costs one byte instead
+ * of two.  The bytes are staged INO_SEND_CHUNK at a time.  Read them with
+ * ino_read_delta_int16s() in libuino.h on the attached computer.
+ * @param buf Pointer to the beginning of an array of int16_t.
+ * @param count The number of integers to send.
+ * @since 0.2
+ */
+void ino_send_delta_int16s(const int16_t *buf, int count);
+
+/** 
+ * Send multiple signed 32-bit integers to computer as a delta stream.
+ * Like ino_send_delta_int16s(), a small change costs one byte instead of
+ * four.  Read them with ino_read_delta_int32s() in libuino.h on the
+ * attached computer.
+ * @param buf Pointer to the beginning of an array of int32_t.
+ * @param count The number of integers to send.
+ * @since 0.2
+ */
+void ino_send_delta_int32s(const int32_t *buf, int count);
+
+/**
+ * Encode signed 16-bit integers as a delta stream into a buffer.
+ * Produces the same bytes as ino_send_delta_int16s(), e.g. to send them as
+ * the payload of ino_send_frame().  Decode them with ino_decode_delta_int16s()
+ * in libuino.h on the attached computer.
+ * @param dst Destination with room for 3 bytes per integer.
+ * @param buf Pointer to the beginning of an array of int16_t.
+ * @param count The number of integers to encode.
+ * @return Number of bytes written to dst.
+ * @since 0.2
+ */
+int ino_encode_delta_int16s(uint8_t *dst, const int16_t *buf, int count);
+
+/**
+ * Encode signed 32-bit integers as a delta stream into a buffer.
+ * Produces the same bytes as ino_send_delta_int32s().  Decode them with
+ * ino_decode_delta_int32s() in libuino.h on the attached computer.
+ * @param dst Destination with room for 5 bytes per integer.
+ * @param buf Pointer to the beginning of an array of int32_t.
+ * @param count The number of integers to encode.
+ * @return Number of bytes written to dst.
+ * @since 0.2
+ */
+int ino_encode_delta_int32s(uint8_t *dst, const int32_t *buf, int count);
+
+
+/** 
+ * Send multiple unsigned integers to computer bit-packed to bits width.
+ * Function to send only the low bits of each integer, back to back and most
+ * significant bit first, with the last byte padded with zero bits.  Four
+ * 10-bit analogRead() values take 5 bytes instead of 8, and two 12-bit
+ * values 3 bytes instead of 4.  Read them with ino_read_packed() in
+ * libuino.h on the attached computer.
+ * @param buf Pointer to the beginning of an array of uint16_t.
+ * @param count The number of integers to send.
+ * @param bits Width of each integer, 1 to 16.
+ * @since 0.2
+ */
+void ino_send_packed(const uint16_t *buf, int count, int bits);
+
+/**
+ * Pack unsigned integers to bits width into a buffer.
+ * Produces the same bytes as ino_send_packed(), e.g. to send them as the
+ * payload of ino_send_frame().  Unpack them with ino_unpack_uint16s() in
+ * libuino.h on the attached computer.
+ * @param dst Destination with room for INO_PACKED_SIZE(count, bits) bytes.
+ * @param buf Pointer to the beginning of an array of uint16_t.
+ * @param count The number of integers to pack.
+ * @param bits Width of each integer, 1 to 16.
+ * @return Number of bytes written to dst.
+ * @since 0.2
+ */
+int ino_pack_uint16s(uint8_t *dst, const uint16_t *buf, int count, int bits);
+
+
+/**
+ * Tell the computer that the sketch is up and ready to communicate.
+ * Sends the single INO_READY_BYTE.  Call it once at the end of setup(),
+ * after Serial.begin(), so that a computer connecting with the
+ * INO_CONNECT_HANDSHAKE mode of libuino.h can start talking the moment the
+ * board has rebooted instead of sleeping for a fixed time.
+ * @since 0.2
+ */
+void ino_send_ready();
+
 #endif
@@ -36,17 +36,20 @@
  * values, then you may use the ino_cast_int(), ino_cast_long(),
  * ino_cast_float(), and ino_cast_double() functions to quickly
  * cast them to numeric types according to their position number.
- * Although if normally reading all numeric values in the order they
- * appear, you may find using the standard C functions strtol(),
- * strtof(), and strtod() slightly faster if that is important.
- * The ino_cast_*() functions are quite convenient though especially
+ * When reading all numeric values in the order they appear, use
+ * ino_cast_ints(), ino_cast_longs(), ino_cast_floats(), or
+ * ino_cast_doubles() instead, which convert every field into an array
+ * in a single pass over the string.  ino_split() indexes the field
+ * offsets for random access without rescanning.
+ * The positional ino_cast_*() functions remain convenient, especially
  * for quickly grabbing a value at a specific position in the string
  * without having to count white-spaces.
  
  * In order to transfer raw, unprocessed bytes, you should use the
  * ino_connection_raw() function to create a ino_connection_t object.
- * The "raw" functions will send and receive 16-bit and 32-bit signed
- * or unsigned integers. All integers are converted to network byte
+ * The "raw" functions will send and receive 16, 32 and 64-bit signed
+ * or unsigned integers as well as IEEE-754 floats and doubles in
+ * binary form. All values are converted to network byte
  * order (i.e., big endian) for sending and then back into host byte
  * order when receiving integer data. To use the raw data functions
  * in the library, more than likely you will also want to include
@@ -54,8 +57,72 @@
  * with the libuino library through the serial port.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include "libuino.h"
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <linux/serial.h>
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define INO_HOST_BIG_ENDIAN 1
+#else
+#define INO_HOST_BIG_ENDIAN 0
+#endif
+
+#if !INO_HOST_BIG_ENDIAN && ( defined(__x86_64__) || defined(__i386__) ) && defined(__GNUC__)
+#define INO_SWAP_X86
+#include <immintrin.h>
+#elif !INO_HOST_BIG_ENDIAN && ( defined(__ARM_NEON) || defined(__aarch64__) )
+#define INO_SWAP_NEON
+#include <arm_neon.h>
+#endif
+
+#if ( defined(__x86_64__) || defined(__i386__) ) && defined(__GNUC__)
+#define INO_CRC_X86
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__linux__) && defined(__GNUC__)
+#define INO_CRC_ARM
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 ( 1 << 7 )
+#endif
+#endif
+
+/*
+ * Linux sets arbitrary bit rates with the termios2 ioctls and BOTHER.  libc
+ * does not declare them alongside termios.h, so the kernel's layout is
+ * mirrored here for the architectures that share the generic definition.
+ */
+#if defined(__linux__) && ( defined(__x86_64__) || defined(__i386__) || defined(__arm__) || defined(__aarch64__) || defined(__riscv) )
+#define INO_HAVE_TERMIOS2
+#define INO_BOTHER 0010000
+#define INO_IBSHIFT 16
+struct ino_termios2
+{
+	tcflag_t c_iflag;
+	tcflag_t c_oflag;
+	tcflag_t c_cflag;
+	tcflag_t c_lflag;
+	cc_t c_line;
+	cc_t c_cc[19];
+	speed_t c_ispeed;
+	speed_t c_ospeed;
+};
+#define INO_TCGETS2 _IOR('T', 0x2A, struct ino_termios2)
+#define INO_TCSETS2 _IOW('T', 0x2B, struct ino_termios2)
+#endif
+
 /**
  * Create a new character-oriented Arduino connection configuration object.
  * Use this function to configure a connection for transfering character data
@@ -92,6 +159,38 @@ ino_connection_new(char *port, speed_t baud, int connect_wait)
 		cnx->raw_size = 0;
 		cnx->raw_timeout = 0;
 		cnx->fd = -1;
+		cnx->in_size = INO_INPUT_BUFFER_SIZE;
+		cnx->in_head = 0;
+		cnx->in_tail = 0;
+		cnx->view_size = 0;
+		cnx->exact = 0;
+		cnx->exact_timeout = INO_NO_TIMEOUT;
+		cnx->nonblock = 0;
+		cnx->lines = 0;
+		cnx->baud_rate = 0;
+		cnx->connect_mode = INO_CONNECT_WAIT;
+		cnx->low_latency = 0;
+		cnx->latency_tunings = 0;
+		cnx->frame_cb = NULL;
+		cnx->frame_arg = NULL;
+		cnx->reader = NULL;
+		cnx->uring = NULL;
+		cnx->out_buf = NULL;
+		cnx->out_size = 0;
+		cnx->out_len = 0;
+		cnx->corked = 0;
+		cnx->flush_threshold = 0;
+		cnx->flush_delay = 0;
+		cnx->scratch = NULL;
+		cnx->scratch_size = 0;
+		cnx->frame_errors = 0;
+		/* allocate the input buffer */
+		cnx->in_buf = (uint8_t *)malloc(cnx->in_size);
+		if ( !cnx->in_buf )
+		{
+			free(cnx);
+			cnx = NULL;
+		}
 	}
 	
 	return cnx;
@@ -128,39 +227,498 @@ ino_connection_raw(char *port, speed_t baud, int connect_wait, int frame_size_by
 {
 	ino_connection_t *cnx = NULL;
 	
-	cnx = (ino_connection_t *)malloc(sizeof(ino_connection_t));
+	cnx = ino_connection_new(port, baud, connect_wait);
 	if ( cnx )
 	{
-		cnx->port = port;
-		cnx->baud = baud;
-		cnx->connect_wait = connect_wait;
 		cnx->raw = 1;
 		cnx->raw_size = frame_size_bytes;
 		cnx->raw_timeout = read_timeout;
-		cnx->fd = -1;
 	}
 	
 	return cnx;
 }
 
+#ifdef __linux__
+/**
+ * Data type for a poller or io_uring engine dispatching a connection's frames.
+ * Each dispatch links itself into the calling thread's chain, so a callback
+ * that destroys a connection can find out who still refers to it.
+ * @since 0.2
+ */
+struct _ino_dispatch_s
+{
+	ino_poller_t *poller;					/* poller whose events are being dispatched; NULL for io_uring */
+	ino_connection_t *cnx;				/* connection whose callback may be running; NULL if none */
+	int destroyed;								/* 1 if cnx was destroyed by a callback, free it when done */
+	struct _ino_dispatch_s *outer;	/* dispatch this one is nested in */
+};
+
+/* innermost dispatch running on this thread */
+static __thread struct _ino_dispatch_s *ino_dispatch = NULL;
+
+/**
+ * Start dispatching on this thread.
+ * @param d Dispatch record to link in, kept until ino_dispatch_leave().
+ * @param poller Poller whose events are dispatched, or NULL for io_uring.
+ * @since 0.2
+ */
+static void
+ino_dispatch_enter(struct _ino_dispatch_s *d, ino_poller_t *poller)
+{
+	d->poller = poller;
+	d->cnx = NULL;
+	d->destroyed = 0;
+	d->outer = ino_dispatch;
+	ino_dispatch = d;
+}
+
+/**
+ * Stop dispatching on this thread.
+ * @param d Dispatch record linked in by ino_dispatch_enter().
+ * @since 0.2
+ */
+static void
+ino_dispatch_leave(struct _ino_dispatch_s *d)
+{
+	ino_dispatch = d->outer;
+}
+#endif
+
+/**
+ * Free a closed connection's memory.
+ * @param cnx Pointer to a closed ino_connection_t object.
+ * @since 0.2
+ */
+static void
+ino_connection_free(ino_connection_t *cnx)
+{
+	free(cnx->in_buf);
+	free(cnx->out_buf);
+	free(cnx->scratch);
+	free(cnx);
+}
+
 /**
  * Close Arduino connection and free config object from memory. 
  * Use this function when the connection is no longer needed.  To merely
  * close the connection and retain it to be opened again later, use the
- * ino_close() function instead.
+ * ino_close() function instead.  Frame callbacks may destroy any connection,
+ * including their own; the memory of their own connection is freed once the
+ * callback returns.
  * @param cnx Pointer to ino_connection_t object to be destroyed.
  * @since 0.1
  */
 void
 ino_connection_destroy(ino_connection_t *cnx)
 {
+#ifdef __linux__
+	struct _ino_dispatch_s self;		/* holds the memory while closing dispatches frames */
+	struct _ino_dispatch_s *d;
+	int j;
+#endif
+
 	if ( cnx )
 	{
+#ifdef __linux__
+		/* detaching from io_uring may run callbacks that destroy cnx again */
+		ino_dispatch_enter(&self, NULL);
+		self.cnx = cnx;
+#endif
 		/* close the connection */
 		ino_close(cnx);
+#ifdef __linux__
+		ino_dispatch_leave(&self);
+		/* forget events still to be dispatched for it */
+		for(d=ino_dispatch; d; d=d->outer)
+			if ( d->poller )
+				for(j=0; j<INO_POLLER_MAX_EVENTS; j++)
+					if ( d->poller->events[j].data.ptr == cnx ) d->poller->events[j].data.ptr = NULL;
+		/* a callback of its own is still running, leave the memory to the dispatcher */
+		for(d=ino_dispatch; d; d=d->outer)
+		{
+			if ( d->cnx == cnx )
+			{
+				d->destroyed = 1;
+				return;
+			}
+		}
+#endif
 		/* free the connection's memory */
-		free(cnx);
+		ino_connection_free(cnx);
+	}
+}
+
+#if !defined(INO_HAVE_TERMIOS2)
+/*
+ * Standard termios speed codes and the bit rates they stand for.
+ */
+static const struct
+{
+	speed_t code;
+	int rate;
+}
+ino_bauds[] =
+{
+	{ B50, 50 }, { B75, 75 }, { B110, 110 }, { B134, 134 }, { B150, 150 },
+	{ B200, 200 }, { B300, 300 }, { B600, 600 }, { B1200, 1200 }, { B1800, 1800 },
+	{ B2400, 2400 }, { B4800, 4800 }, { B9600, 9600 }, { B19200, 19200 }, { B38400, 38400 },
+#ifdef B57600
+	{ B57600, 57600 },
+#endif
+#ifdef B115200
+	{ B115200, 115200 },
+#endif
+#ifdef B230400
+	{ B230400, 230400 },
+#endif
+#ifdef B460800
+	{ B460800, 460800 },
+#endif
+#ifdef B500000
+	{ B500000, 500000 },
+#endif
+#ifdef B921600
+	{ B921600, 921600 },
+#endif
+#ifdef B1000000
+	{ B1000000, 1000000 },
+#endif
+#ifdef B1500000
+	{ B1500000, 1500000 },
+#endif
+#ifdef B2000000
+	{ B2000000, 2000000 },
+#endif
+#ifdef B3000000
+	{ B3000000, 3000000 },
+#endif
+#ifdef B4000000
+	{ B4000000, 4000000 },
+#endif
+};
+#endif
+
+/**
+ * Read back the output bit rate the open port is running at.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @return Bit rate, or -1 on error.
+ * @since 0.2
+ */
+static int
+ino_read_baud_rate(ino_connection_t *cnx)
+{
+#if defined(INO_HAVE_TERMIOS2)
+	struct ino_termios2 t2;
+	
+	if ( ioctl(cnx->fd, INO_TCGETS2, &t2) == -1 ) return -1;
+	
+	return (int)t2.c_ospeed;
+#else
+	struct termios toptions;
+	speed_t code;
+	size_t i;
+	
+	if ( tcgetattr(cnx->fd, &toptions) == -1 ) return -1;
+	code = cfgetospeed(&toptions);
+	for(i=0; i<sizeof(ino_bauds)/sizeof(ino_bauds[0]); i++)
+		if ( ino_bauds[i].code == code ) return ino_bauds[i].rate;
+	
+	/* speed codes are the bit rate itself on BSD and macOS */
+	return (int)code;
+#endif
+}
+
+/**
+ * Set an integer bit rate on the open port and check what the driver applied.
+ * The previous settings are restored if the rate cannot be applied.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @param rate Bit rate, e.g. 250000.
+ * @return The bit rate applied, or -1 on error or if the driver's rate is more
+ *         than INO_BAUD_TOLERANCE percent off.
+ * @since 0.2
+ */
+static int
+ino_apply_baud_rate(ino_connection_t *cnx, int rate)
+{
+	int actual = -1;
+	int err;
+#if defined(INO_HAVE_TERMIOS2)
+	struct ino_termios2 t2, saved;
+	
+	if ( ioctl(cnx->fd, INO_TCGETS2, &saved) == -1 ) return -1;
+	t2 = saved;
+	t2.c_cflag &= ~( CBAUD | ( CBAUD << INO_IBSHIFT ) );
+	t2.c_cflag |= INO_BOTHER | ( INO_BOTHER << INO_IBSHIFT );
+	t2.c_ispeed = rate;
+	t2.c_ospeed = rate;
+	if ( ioctl(cnx->fd, INO_TCSETS2, &t2) == 0 )
+#else
+	struct termios toptions, saved;
+	speed_t code = (speed_t)rate;
+	size_t i;
+	
+	if ( tcgetattr(cnx->fd, &saved) == -1 ) return -1;
+	toptions = saved;
+	for(i=0; i<sizeof(ino_bauds)/sizeof(ino_bauds[0]); i++)
+		if ( ino_bauds[i].rate == rate ) code = ino_bauds[i].code;
+	if ( cfsetispeed(&toptions, code) == 0 && cfsetospeed(&toptions, code) == 0
+		&& tcsetattr(cnx->fd, TCSANOW, &toptions) == 0 )
+#endif
+	{
+		/* drivers round to what their divisor allows, make sure it is close enough */
+		actual = ino_read_baud_rate(cnx);
+		if ( actual != -1 && (long long)( actual > rate ? actual - rate : rate - actual ) * 100 > (long long)rate * INO_BAUD_TOLERANCE )
+		{
+			errno = EINVAL;
+			actual = -1;
+		}
+	}
+	
+	/* leave the port at the rate it had */
+	if ( actual == -1 )
+	{
+		err = errno;
+#if defined(INO_HAVE_TERMIOS2)
+		ioctl(cnx->fd, INO_TCSETS2, &saved);
+#else
+		tcsetattr(cnx->fd, TCSANOW, &saved);
+#endif
+		errno = err;
+	}
+	
+	return actual;
+}
+
+static int ino_set_nonblock(ino_connection_t *cnx, int nonblock);
+static int ino_wait_readable(ino_connection_t *cnx, const struct timespec *deadline);
+static void ino_deadline(struct timespec *deadline, long timeout_us);
+static int ino_time_left(const struct timespec *deadline, struct timespec *left);
+
+/**
+ * Prepare a freshly opened port for the ready byte handshake.
+ * Input left over from before the reset is discarded.  Canonical connections
+ * are switched to non-canonical input meanwhile, as the ready byte is not
+ * followed by a new line.
+ * @param cnx Pointer to a freshly opened and configured ino_connection_t object.
+ * @param saved Filled with the port settings to restore afterwards.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+static int
+ino_handshake_begin(ino_connection_t *cnx, struct termios *saved)
+{
+	struct termios toptions;
+	
+	if ( tcgetattr(cnx->fd, saved) == -1 ) return -1;
+	if ( saved->c_lflag & ICANON )
+	{
+		toptions = *saved;
+		toptions.c_lflag &= ~ICANON;
+		toptions.c_cc[VMIN]  = 1;
+		toptions.c_cc[VTIME] = 0;
+		if ( tcsetattr(cnx->fd, TCSANOW, &toptions) == -1 ) return -1;
+	}
+	tcflush(cnx->fd, TCIFLUSH);
+	
+	return ino_set_nonblock(cnx, 1);
+}
+
+/**
+ * Look for the ready byte among the bytes the port has ready.
+ * Reads a byte at a time so nothing after the ready byte is consumed;
+ * anything before it is discarded.
+ * @param cnx Pointer to ino_connection_t object prepared by ino_handshake_begin().
+ * @return 1 once the ready byte arrived, 0 if more bytes are needed, or -1
+ *         on error or hang up.
+ * @since 0.2
+ */
+static int
+ino_handshake_scan(ino_connection_t *cnx)
+{
+	uint8_t b;
+	int n;
+	
+	for ( ;; )
+	{
+		n = read(cnx->fd, &b, 1);
+		if ( n == 1 && b == INO_READY_BYTE )
+			return 1;
+		else if ( n == 1 || ( n < 0 && errno == EINTR ) )
+			continue;
+		else if ( n < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK ) )
+			return 0;
+		if ( n == 0 ) errno = EIO;
+		return -1;
+	}
+}
+
+/**
+ * Restore the port settings changed by ino_handshake_begin(), including
+ * blocking mode.
+ * @param cnx Pointer to ino_connection_t object prepared by ino_handshake_begin().
+ * @param saved Port settings filled by ino_handshake_begin().
+ * @since 0.2
+ */
+static void
+ino_handshake_end(ino_connection_t *cnx, const struct termios *saved)
+{
+	if ( saved->c_lflag & ICANON ) tcsetattr(cnx->fd, TCSANOW, saved);
+	ino_set_nonblock(cnx, 0);
+}
+
+/**
+ * Wait for the ready byte sent by ino_send_ready() in the Arduino library.
+ * @param cnx Pointer to a freshly opened and configured ino_connection_t object.
+ * @param timeout_us Microseconds to wait for the board to come up.
+ * @return -1 with errno set to ETIMEDOUT if the board did not report ready
+ *         in time, zero on success.
+ * @since 0.2
+ */
+static int
+ino_handshake(ino_connection_t *cnx, long timeout_us)
+{
+	struct termios saved;				/* port settings to restore */
+	struct timespec deadline;		/* when to give up */
+	int n;
+	
+	if ( ino_handshake_begin(cnx, &saved) == -1 ) return -1;
+	ino_deadline(&deadline, timeout_us);
+	while ( ( n = ino_handshake_scan(cnx) ) == 0 )
+	{
+		if ( ino_wait_readable(cnx, &deadline) <= 0 )
+		{
+			errno = ETIMEDOUT;
+			n = -1;
+			break;
+		}
+	}
+	ino_handshake_end(cnx, &saved);
+	
+	return n == 1 ? 0 : -1;
+}
+
+#ifdef __linux__
+static int ino_sysfs_read(const char *dir, const char *name, char *buf, int size);
+#endif
+
+/**
+ * Tune the driver of an open port for latency where it allows.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @return The INO_TUNED_ flags in effect.
+ * @since 0.2
+ */
+static int
+ino_tune_latency(ino_connection_t *cnx)
+{
+	int tunings = 0;
+#ifdef __linux__
+	struct serial_struct ser;
+	char real[PATH_MAX];		/* node with symlinks resolved */
+	char dir[PATH_MAX];			/* sysfs directory of the tty's device */
+	char val[16];
+	int fd;
+	
+	/* drivers without TIOCGSERIAL, e.g. ptys, fail with ENOTTY or EINVAL */
+	if ( ioctl(cnx->fd, TIOCGSERIAL, &ser) == 0 )
+	{
+		if ( !( ser.flags & ASYNC_LOW_LATENCY ) )
+		{
+			ser.flags |= ASYNC_LOW_LATENCY;
+			/* some drivers accept the flag without keeping it, read it back */
+			if ( ioctl(cnx->fd, TIOCSSERIAL, &ser) == -1 || ioctl(cnx->fd, TIOCGSERIAL, &ser) == -1 )
+				ser.flags = 0;
+		}
+		if ( ser.flags & ASYNC_LOW_LATENCY ) tunings |= INO_TUNED_ASYNC_LOW_LATENCY;
+	}
+	
+	/* FTDI and similar bridges flush their buffer when the latency timer expires */
+	if ( realpath(cnx->port, real)
+		&& snprintf(dir, sizeof(dir) - sizeof("/latency_timer"), "/sys/class/tty/%s/device", strrchr(real, '/') + 1)
+			< (int)( sizeof(dir) - sizeof("/latency_timer") )
+		&& ino_sysfs_read(dir, "latency_timer", val, sizeof(val)) > 0 )
+	{
+		if ( atoi(val) > INO_LATENCY_TIMER_MS )
+		{
+			/* usually needs root or a udev rule, just like setting it by hand */
+			strcat(dir, "/latency_timer");
+			fd = open(dir, O_WRONLY | O_CLOEXEC);
+			if ( fd > -1 )
+			{
+				snprintf(val, sizeof(val), "%d", INO_LATENCY_TIMER_MS);
+				if ( write(fd, val, strlen(val)) > 0 ) tunings |= INO_TUNED_LATENCY_TIMER;
+				close(fd);
+			}
+		}
+		else
+			tunings |= INO_TUNED_LATENCY_TIMER;
+	}
+#endif
+	
+	return tunings;
+}
+
+/**
+ * Apply the connection's settings to its freshly opened port.
+ * @param cnx Pointer to ino_connection_t object with an open port.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+static int
+ino_configure(ino_connection_t *cnx)
+{
+	int error;
+	int dtr = TIOCM_DTR;
+	struct termios toptions;
+	
+	/* init toptions with current port settings */
+	tcgetattr(cnx->fd, &toptions);
+	toptions.c_cflag = 0;
+	toptions.c_iflag = 0;
+	toptions.c_oflag = 0;
+	toptions.c_lflag = 0;
+
+	/* new port settings */
+	cfsetispeed(&toptions, cnx->baud);	/* input baud*/
+	cfsetospeed(&toptions, cnx->baud);	/* output baud*/
+	toptions.c_cflag |= ( CS8 | HUPCL | CREAD | CLOCAL );
+	/* keep DTR raised on close so the next open does not reset the board */
+	if ( cnx->connect_mode & INO_CONNECT_NO_RESET ) toptions.c_cflag &= ~HUPCL;
+	if ( cnx->raw && cnx->exact )
+	{
+		/* exact reads assemble frames themselves, wake on every byte */
+		toptions.c_cc[VMIN]  = 1;
+		toptions.c_cc[VTIME] = 0;
+	}
+	else if ( cnx->raw )
+	{
+		/* set min bytes and timeout, VMIN cannot exceed 255 */
+		toptions.c_cc[VMIN]  = cnx->raw_size < 255 ? cnx->raw_size : 255;
+		toptions.c_cc[VTIME] = cnx->raw_timeout;
+	}
+	else if ( cnx->lines )
+	{
+		/* lines are split in user space, read raw and wake on every byte */
+		toptions.c_cc[VMIN]  = 1;
+		toptions.c_cc[VTIME] = 0;
+	}
+	else
+	{
+		/* canonical, turn on processing */
+		toptions.c_lflag |= ( ICANON | ECHOE | ECHOK | ECHOCTL | ECHOKE );
+	}
+	
+	/* commit changes to port settings */
+	error = tcsetattr(cnx->fd, TCSANOW, &toptions);
+	/* replace the speed code with the integer bit rate if one was set */
+	if ( error == 0 && cnx->baud_rate > 0 && ino_apply_baud_rate(cnx, cnx->baud_rate) == -1 ) error = -1;
+	if ( error == 0 && ( cnx->connect_mode & INO_CONNECT_NO_RESET ) )
+	{
+		/* hold DTR; ports without modem lines, such as ptys, do not need it */
+		ioctl(cnx->fd, TIOCMBIS, &dtr);
 	}
+	cnx->latency_tunings = ( error == 0 && cnx->low_latency ) ? ino_tune_latency(cnx) : 0;
+	
+	return error;
 }
 
 /**
@@ -175,7 +733,6 @@ int
 ino_open(ino_connection_t *cnx)
 {
   int error = -1;
-  struct termios toptions;
   
   if ( cnx )
   {
@@ -184,42 +741,231 @@ ino_open(ino_connection_t *cnx)
   	
 		/* open serial port */
 		cnx->fd = open(cnx->port, O_RDWR | O_NOCTTY);
+		cnx->nonblock = 0;
 		
 		if ( cnx->fd >= 0 )
 		{
-			/* wait for the Arduino to reboot */
-			usleep(cnx->connect_wait);
-		
-			/* init toptions with current port settings */
-			tcgetattr(cnx->fd, &toptions);
-			toptions.c_cflag = 0;
-			toptions.c_iflag = 0;
-			toptions.c_oflag = 0;
-			toptions.c_lflag = 0;
-
-			/* new port settings */
-			cfsetispeed(&toptions, cnx->baud);	/* input baud*/
-			cfsetospeed(&toptions, cnx->baud);	/* output baud*/
-			toptions.c_cflag |= ( CS8 | HUPCL | CREAD | CLOCAL );
-			if ( cnx->raw )
+			/* wait for the Arduino to reboot, unless it will say when it is up or is not rebooting */
+			if ( !( cnx->connect_mode & ( INO_CONNECT_HANDSHAKE | INO_CONNECT_NO_RESET ) ) )
+				usleep(cnx->connect_wait);
+			
+			error = ino_configure(cnx);
+			if ( error == 0 && ( cnx->connect_mode & INO_CONNECT_HANDSHAKE ) && !( cnx->connect_mode & INO_CONNECT_NO_RESET ) )
+				error = ino_handshake(cnx, cnx->connect_wait);
+			if ( error == -1 ) ino_close(cnx);
+		}
+	}
+	
+  return error;
+}
+
+/* states of a connection during ino_open_all() */
+#define INO_OPENING_DONE 0
+#define INO_OPENING_BOOTING 1
+#define INO_OPENING_HANDSHAKE 2
+
+/**
+ * Data type for the state of a connection being opened by ino_open_all().
+ * @since 0.2
+ */
+struct _ino_opening_s
+{
+	int state;								/* one of the INO_OPENING_ constants */
+	struct timespec due;			/* end of the boot window or handshake */
+	struct termios saved;			/* port settings to restore after the handshake */
+};
+
+/**
+ * Open many configured serial ports to Arduinos at once.
+ * Opening each connection with ino_open() in turn costs one reboot wait per
+ * board.  This function opens every port first, so all the boards reset
+ * together, and then waits for all of them at the same time: connections in
+ * INO_CONNECT_WAIT mode are configured as their connect_wait runs out,
+ * connections in INO_CONNECT_HANDSHAKE mode are polled together for their
+ * ready bytes, and connections in INO_CONNECT_NO_RESET mode are configured
+ * right away.  Opening a fleet of boards takes about as long as the slowest
+ * board.  Connections that are already open are closed and reopened.
+ * @param cnxs Array of pointers to ino_connection_t objects to open.
+ * @param count Number of connections in cnxs.
+ * @param status Array of count ints filled with zero for each connection
+ *        opened and the errno value for each connection that failed, e.g.
+ *        ETIMEDOUT if a board did not report ready in time; may be NULL.
+ * @return The number of connections opened, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_open_all(ino_connection_t **cnxs, int count, int *status)
+{
+	struct _ino_opening_s *op;		/* state of each connection */
+	struct pollfd *pfds;					/* handshaking ports to poll */
+	int *which;										/* connection of each entry in pfds */
+	struct timespec start;				/* when the boards were reset */
+	struct timespec next = { 0, 0 };	/* earliest boot window or handshake end */
+	struct timespec left;					/* time left until next */
+	int i, n, npfds, pending, opened, error;
+	
+	if ( !cnxs || count < 0 )
+	{
+		errno = EINVAL;
+		return -1;
+	}
+	
+	op = (struct _ino_opening_s *)calloc(count ? count : 1, sizeof(*op));
+	pfds = (struct pollfd *)malloc(( count ? count : 1 ) * sizeof(*pfds));
+	which = (int *)malloc(( count ? count : 1 ) * sizeof(*which));
+	if ( !op || !pfds || !which )
+	{
+		free(op);
+		free(pfds);
+		free(which);
+		errno = ENOMEM;
+		return -1;
+	}
+	
+	/* open every port first so all the boards reset together */
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(i=0; i<count; i++)
+	{
+		error = 0;
+		if ( !cnxs[i] )
+		{
+			error = EINVAL;
+		}
+		else
+		{
+			if ( cnxs[i]->fd > -1 ) ino_close(cnxs[i]);
+			cnxs[i]->fd = open(cnxs[i]->port, O_RDWR | O_NOCTTY);
+			cnxs[i]->nonblock = 0;
+			if ( cnxs[i]->fd < 0 ) error = errno;
+		}
+		if ( status ) status[i] = error;
+	}
+	
+	/* start the handshakes, configure what does not wait at all */
+	for(i=0; i<count; i++)
+	{
+		if ( !cnxs[i] || cnxs[i]->fd < 0 ) continue;
+		
+		op[i].due = start;
+		op[i].due.tv_sec += cnxs[i]->connect_wait / 1000000;
+		op[i].due.tv_nsec += ( cnxs[i]->connect_wait % 1000000 ) * 1000;
+		if ( op[i].due.tv_nsec >= 1000000000 )
+		{
+			op[i].due.tv_sec++;
+			op[i].due.tv_nsec -= 1000000000;
+		}
+		
+		error = 0;
+		if ( cnxs[i]->connect_mode & INO_CONNECT_NO_RESET )
+			error = ino_configure(cnxs[i]);
+		else if ( cnxs[i]->connect_mode & INO_CONNECT_HANDSHAKE )
+		{
+			error = ino_configure(cnxs[i]);
+			if ( error == 0 ) error = ino_handshake_begin(cnxs[i], &op[i].saved);
+			if ( error == 0 ) op[i].state = INO_OPENING_HANDSHAKE;
+		}
+		else
+			op[i].state = INO_OPENING_BOOTING;
+		
+		if ( error == -1 )
+		{
+			if ( status ) status[i] = errno;
+			ino_close(cnxs[i]);
+		}
+	}
+	
+	/* wait for the boot windows and ready bytes of all the boards together */
+	for ( ;; )
+	{
+		pending = 0;
+		npfds = 0;
+		for(i=0; i<count; i++)
+		{
+			if ( op[i].state == INO_OPENING_DONE ) continue;
+			
+			error = 0;
+			n = 0;
+			if ( op[i].state == INO_OPENING_HANDSHAKE )
 			{
-				/* set min bytes and timeout */
-				toptions.c_cc[VMIN]  = cnx->raw_size;
-				toptions.c_cc[VTIME] = cnx->raw_timeout;
+				n = ino_handshake_scan(cnxs[i]);
+				if ( n == 0 && !ino_time_left(&op[i].due, &left) )
+				{
+					errno = ETIMEDOUT;
+					n = -1;
+				}
+				if ( n != 0 ) ino_handshake_end(cnxs[i], &op[i].saved);
+				if ( n == -1 ) error = errno;
 			}
-			else
+			else if ( !ino_time_left(&op[i].due, &left) )
 			{
-				/* canonical, turn on processing */
-				toptions.c_lflag |= ( ICANON | ECHOE | ECHOK | ECHOCTL | ECHOKE );
+				/* boot window over */
+				n = 1;
+				if ( ino_configure(cnxs[i]) == -1 ) error = errno;
 			}
 			
-			/* commit changes to port settings */
-			error = tcsetattr(cnx->fd, TCSANOW, &toptions);
-			if ( error == -1 ) ino_close(cnx);
+			if ( n != 0 )
+			{
+				op[i].state = INO_OPENING_DONE;
+				if ( error )
+				{
+					if ( status ) status[i] = error;
+					ino_close(cnxs[i]);
+				}
+				continue;
+			}
+			
+			if ( !pending++ || op[i].due.tv_sec < next.tv_sec
+				|| ( op[i].due.tv_sec == next.tv_sec && op[i].due.tv_nsec < next.tv_nsec ) )
+				next = op[i].due;
+			if ( op[i].state == INO_OPENING_HANDSHAKE )
+			{
+				pfds[npfds].fd = cnxs[i]->fd;
+				pfds[npfds].events = POLLIN;
+				which[npfds++] = i;
+			}
+		}
+		if ( !pending ) break;
+		
+		if ( !ino_time_left(&next, &left) ) continue;
+#ifdef __linux__
+		n = ppoll(pfds, npfds, &left, NULL);
+#else
+		n = poll(pfds, npfds, (int)( left.tv_sec * 1000 + ( left.tv_nsec + 999999 ) / 1000000 ));
+#endif
+		if ( n < 0 && errno != EINTR ) break;
+		
+		/* a port that hung up without the ready byte has failed */
+		for(i=0; n > 0 && i<npfds; i++)
+		{
+			if ( ( pfds[i].revents & ( POLLHUP | POLLERR | POLLNVAL ) ) && !( pfds[i].revents & POLLIN ) )
+			{
+				ino_handshake_end(cnxs[which[i]], &op[which[i]].saved);
+				op[which[i]].state = INO_OPENING_DONE;
+				if ( status ) status[which[i]] = EIO;
+				ino_close(cnxs[which[i]]);
+			}
 		}
 	}
 	
-  return error;
+	/* only reached early if polling failed, give up on what is left */
+	error = errno;
+	for(i=0; i<count; i++)
+	{
+		if ( op[i].state == INO_OPENING_DONE ) continue;
+		if ( op[i].state == INO_OPENING_HANDSHAKE ) ino_handshake_end(cnxs[i], &op[i].saved);
+		if ( status ) status[i] = error;
+		ino_close(cnxs[i]);
+	}
+	
+	opened = 0;
+	for(i=0; i<count; i++)
+		if ( cnxs[i] && cnxs[i]->fd > -1 ) opened++;
+	
+	free(op);
+	free(pfds);
+	free(which);
+	
+	return opened;
 }
 
 /**
@@ -239,10 +985,22 @@ ino_close(ino_connection_t *cnx)
 	/* if connected */	
 	if ( cnx && cnx->fd > -1 )
 	{
+		/* send anything still corked */
+		ino_flush(cnx);
+		/* stop the background reader before its port goes away */
+		if ( cnx->reader && ino_reader_stop(cnx) == -1 ) error = -1;
+#ifdef __linux__
+		/* likewise for io_uring requests */
+		if ( cnx->uring ) ino_uring_remove(cnx);
+#endif
+		/* close serial port */
+		if ( close(cnx->fd) == -1 ) error = -1;
 		/* mark connection closed */
 		cnx->fd = -1;
-		/* close serial port */
-		error = close(cnx->fd);
+		/* discard any unread input */
+		cnx->in_head = 0;
+		cnx->in_tail = 0;
+		cnx->view_size = 0;
 	}
 	
 	return error;
@@ -263,62 +1021,670 @@ int ino_is_open(ino_connection_t *cnx)
 }
 
 /**
- * Read a string from the Arduino.
- * Read processed, canonical, string-oriented i/o, terminated by new line character.
- * The connection must be created using the ino_connection_new() function and
- * opened using ino_open().
- * @param cnx Pointer to ino_connection_t object from which to be read.
- * @param buf String buffer into which to read the string from the Arduino.
- * @param max_bytes Maximum number of bytes to read, e.g., size of buffer.
- * @return -1 on error or number of bytes read otherwise.
- * @since 0.1
+ * Choose how ino_open() waits for the Arduino to come up.
+ * Takes effect at the next ino_open().
+ * @param cnx Pointer to ino_connection_t object to configure.
+ * @param mode INO_CONNECT_WAIT, INO_CONNECT_HANDSHAKE or INO_CONNECT_NO_RESET.
+ * @return -1 on error and zero on success.
+ * @since 0.2
  */
 int
-ino_read(ino_connection_t *cnx, char *buf, int max_bytes)
+ino_set_connect_mode(ino_connection_t *cnx, int mode)
 {
-  int n = -1;		/* return number of bytes read or -1 on error */
-
-	/* if connected */
-	if ( cnx && cnx->fd > -1 )
+	int error = -1;
+	
+	if ( cnx && !( mode & ~( INO_CONNECT_HANDSHAKE | INO_CONNECT_NO_RESET ) ) )
 	{
-		/* receive string from arduino */
-		n = read(cnx->fd, buf, max_bytes);
-		/* insert terminating zero in the string */
-		buf[n] = '\0';
- 	}
- 	
-  return n;
+		cnx->connect_mode = mode;
+		error = 0;
+	}
+	
+	return error;
 }
 
 /**
- * Cast white-space delimited string data to int by position in the string.
- * Extract numeric value at position, "pos," in the string.  E.g., in order
- * to extract an int at the beginning of the string, use pos = 0. In order
- * to extract the second numeric value in the string, use pos = 1, etc.
- * @param frame Frame of characters returned by ino_read().
- * @param pos Position in the frame of numeric values, starting with zero.
- * @return The integer read at the given position, or zero on error.
- * @since 0.1
+ * Use an integer bit rate instead of the connection's termios speed code.
+ * Applied right away if the connection is open, otherwise by ino_open().
+ * A rejected rate leaves the connection at its previous one.
+ * @param cnx Pointer to ino_connection_t object to configure.
+ * @param rate Bit rate, e.g. 250000, 500000, 1000000 or 2000000.
+ * @return The bit rate the driver applied, rate itself if not open yet, or -1
+ *         on error or if the driver cannot get within INO_BAUD_TOLERANCE percent.
+ * @since 0.2
  */
 int
-ino_cast_int(char *frame, int pos)
+ino_set_baud_rate(ino_connection_t *cnx, int rate)
 {
-	int val = 0;
-	char *start = frame;
-	char *end = NULL;
-	char *delims = " \t\r\n;|";
-	int len = strlen(frame);
-	int j = 0;
-
-	while ( j<pos && start < frame+len )
+	int actual = -1;
+	
+	if ( cnx && rate > 0 )
 	{
-		start = strpbrk(start,delims) + 1;
-		while( start < frame+len && strchr(delims,*start) )
+		actual = cnx->fd > -1 ? ino_apply_baud_rate(cnx, rate) : rate;
+		/* keep the previous rate if the driver would not take this one */
+		if ( actual != -1 ) cnx->baud_rate = rate;
+	}
+	
+	return actual;
+}
+
+/**
+ * Get the bit rate an open connection is running at.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @return Bit rate reported by the driver, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_get_baud_rate(ino_connection_t *cnx)
+{
+	return ( cnx && cnx->fd > -1 ) ? ino_read_baud_rate(cnx) : -1;
+}
+
+/**
+ * Tune the serial driver for latency rather than throughput.
+ * Applied right away if the connection is open, otherwise by ino_open().
+ * Turning it off again leaves the driver as it is.
+ * @param cnx Pointer to ino_connection_t object to configure.
+ * @param low_latency 1 to tune the driver when opening, 0 to leave it alone.
+ * @return The INO_TUNED_ flags in effect if the connection is open, zero if
+ *         not, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_set_low_latency(ino_connection_t *cnx, int low_latency)
+{
+	int tunings = -1;
+	
+	if ( cnx )
+	{
+		cnx->low_latency = low_latency ? 1 : 0;
+		if ( cnx->fd > -1 && cnx->low_latency ) cnx->latency_tunings = ino_tune_latency(cnx);
+		tunings = cnx->fd > -1 ? cnx->latency_tunings : 0;
+	}
+	
+	return tunings;
+}
+
+/**
+ * Get the latency tunings in effect on an open connection.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @return INO_TUNED_ASYNC_LOW_LATENCY and INO_TUNED_LATENCY_TIMER or'ed
+ *         together, zero if none, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_get_latency_tunings(ino_connection_t *cnx)
+{
+	return ( cnx && cnx->fd > -1 ) ? cnx->latency_tunings : -1;
+}
+
+static int ino_find_delim(ino_connection_t *cnx, int delim, const struct timespec *deadline);
+
+/**
+ * Read a string from the Arduino.
+ * Read processed, canonical, string-oriented i/o, terminated by new line character.
+ * The connection must be created using the ino_connection_new() function and
+ * opened using ino_open().
+ * @param cnx Pointer to ino_connection_t object from which to be read.
+ * @param buf String buffer into which to read the string from the Arduino.
+ * @param max_bytes Maximum number of bytes to read, e.g., size of buffer.
+ * @return -1 on error or number of bytes read otherwise.
+ * @since 0.1
+ */
+int
+ino_read(ino_connection_t *cnx, char *buf, int max_bytes)
+{
+  int n = -1;		/* return number of bytes read or -1 on error */
+
+	/* if connected and splitting lines in user space */
+	if ( cnx && cnx->fd > -1 && cnx->lines && !cnx->raw )
+	{
+		ino_release_view(cnx);
+		n = ino_find_delim(cnx, '\n', NULL);
+		/* on hang up hand out whatever is left, like a canonical read at end of file */
+		if ( n == 0 ) n = cnx->in_tail - cnx->in_head;
+		if ( n >= max_bytes ) n = max_bytes - 1;
+		if ( n >= 0 )
+		{
+			memcpy(buf, cnx->in_buf + cnx->in_head, n);
+			buf[n] = '\0';
+			cnx->in_head += n;
+			if ( cnx->in_head == cnx->in_tail ) cnx->in_head = cnx->in_tail = 0;
+		}
+	}
+	/* if connected */
+	else if ( cnx && cnx->fd > -1 )
+	{
+		/* receive string from arduino */
+		n = read(cnx->fd, buf, max_bytes);
+		/* insert terminating zero in the string */
+		buf[n] = '\0';
+ 	}
+ 	
+  return n;
+}
+
+/*
+ * Fast number parsing.  Arduinos print short decimal numbers, which are
+ * converted here without strtol()/strtod(): digits are consumed eight at a
+ * time with SWAR arithmetic, and reals whose decimal mantissa and exponent
+ * are both small enough to be exact in floating point are finished with a
+ * single multiply or divide (Clinger's fast path), which is correctly
+ * rounded.  Everything else, e.g. very long mantissas, large exponents, hex,
+ * inf or nan, falls back to strtod()/strtof() under the "C" locale, so the
+ * decimal point is always '.' whatever the application's locale.
+ */
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+#define INO_PARSE_FAST_REAL 1
+#else
+#define INO_PARSE_FAST_REAL 0
+#endif
+
+static const double ino_pow10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const float ino_pow10f[] = {
+	1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+static locale_t ino_c_locale = (locale_t)0;
+static pthread_once_t ino_c_locale_once = PTHREAD_ONCE_INIT;
+
+static void
+ino_c_locale_init(void)
+{
+	ino_c_locale = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+}
+
+/**
+ * Load 8 characters as an integer with the first character in the low byte.
+ * @since 0.2
+ */
+static inline uint64_t
+ino_load8(const char *p)
+{
+	uint64_t v;
+	
+	memcpy(&v, p, 8);
+#if INO_HOST_BIG_ENDIAN
+	v = __builtin_bswap64(v);
+#endif
+	
+	return v;
+}
+
+/**
+ * Test whether all 8 characters loaded by ino_load8() are decimal digits.
+ * @since 0.2
+ */
+static inline int
+ino_is_eight_digits(uint64_t v)
+{
+	return ( ( v & 0xF0F0F0F0F0F0F0F0ULL ) |
+	         ( ( ( v + 0x0606060606060606ULL ) & 0xF0F0F0F0F0F0F0F0ULL ) >> 4 ) ) == 0x3333333333333333ULL;
+}
+
+/**
+ * Convert 8 decimal digits loaded by ino_load8() to their value.
+ * @since 0.2
+ */
+static inline uint32_t
+ino_eight_digits(uint64_t v)
+{
+	v -= 0x3030303030303030ULL;
+	v = ( v * 10 ) + ( v >> 8 );
+	v = ( ( ( v & 0x000000FF000000FFULL ) * 0x000F424000000064ULL ) +
+	      ( ( ( v >> 16 ) & 0x000000FF000000FFULL ) * 0x0000271000000001ULL ) ) >> 32;
+	
+	return (uint32_t)v;
+}
+
+/**
+ * Accumulate a run of decimal digits.
+ * The accumulator wraps once more than 19 digits have been seen; callers
+ * check ndigits before trusting it.
+ * @param p First character to examine.
+ * @param last End of the input.
+ * @param acc Accumulated value, updated.
+ * @param ndigits Count of accumulated digits, updated.
+ * @return Position of the first non-digit.
+ * @since 0.2
+ */
+static const char *
+ino_scan_digits(const char *p, const char *last, uint64_t *acc, int *ndigits)
+{
+	uint64_t v;
+	
+	while ( last - p >= 8 )
+	{
+		v = ino_load8(p);
+		if ( !ino_is_eight_digits(v) ) break;
+		*acc = *acc * 100000000 + ino_eight_digits(v);
+		*ndigits += 8;
+		p += 8;
+	}
+	while ( p < last && (unsigned)( *p - '0' ) < 10 )
+	{
+		*acc = *acc * 10 + (unsigned)( *p - '0' );
+		(*ndigits)++;
+		p++;
+	}
+	
+	return p;
+}
+
+/**
+ * Skip the white-space strtod() and strtol() skip, independent of locale.
+ * @since 0.2
+ */
+static const char *
+ino_skip_space(const char *p, const char *last)
+{
+	while ( p < last && ( *p == ' ' || ( *p >= '\t' && *p <= '\r' ) ) ) p++;
+	
+	return p;
+}
+
+/**
+ * Scan a decimal real number into a mantissa and a power of ten exponent.
+ * @param p Start of the number, after any white-space.
+ * @param last End of the input.
+ * @param mant Filled with the significant digits.
+ * @param ndigits Filled with the number of significant digits.
+ * @param exp10 Filled with the power of ten to apply to mant.
+ * @param neg Filled with 1 if the number is negative.
+ * @return Position after the number, p if there is no number, or NULL if the
+ * text must be handed to strtod(), e.g. hex, inf or nan.
+ * @since 0.2
+ */
+static const char *
+ino_scan_real(const char *p, const char *last, uint64_t *mant, int *ndigits, long *exp10, int *neg)
+{
+	const char *start = p;		/* returned when there is no number */
+	const char *q;						/* digit run or exponent scan position */
+	int any = 0;							/* any mantissa digits seen */
+	int eneg = 0;							/* negative exponent */
+	long x = 0;								/* explicit exponent */
+	
+	*mant = 0;
+	*ndigits = 0;
+	*exp10 = 0;
+	*neg = 0;
+	
+	if ( p < last && ( *p == '+' || *p == '-' ) ) *neg = ( *p++ == '-' );
+	/* leading zeros are not significant */
+	q = p;
+	while ( p < last && *p == '0' ) p++;
+	if ( p - q == 1 && p < last && ( *p == 'x' || *p == 'X' ) ) return NULL;
+	any = ( p > q );
+	q = p;
+	p = ino_scan_digits(p, last, mant, ndigits);
+	any |= ( p > q );
+	if ( p < last && *p == '.' )
+	{
+		p++;
+		q = p;
+		if ( *ndigits == 0 )
+		{
+			while ( p < last && *p == '0' ) p++;
+			*exp10 -= p - q;
+		}
+		q = p;
+		p = ino_scan_digits(p, last, mant, ndigits);
+		*exp10 -= p - q;
+		any |= ( p > q ) || ( *exp10 != 0 );
+	}
+	if ( !any )
+	{
+		p = start + ( start < last && ( *start == '+' || *start == '-' ) );
+		if ( p < last && ( *p == 'i' || *p == 'I' || *p == 'n' || *p == 'N' ) ) return NULL;
+		return start;
+	}
+	if ( p < last && ( *p == 'e' || *p == 'E' ) )
+	{
+		q = p + 1;
+		if ( q < last && ( *q == '+' || *q == '-' ) ) eneg = ( *q++ == '-' );
+		if ( q < last && (unsigned)( *q - '0' ) < 10 )
+		{
+			while ( q < last && (unsigned)( *q - '0' ) < 10 )
+			{
+				if ( x < 100000 ) x = x * 10 + ( *q - '0' );
+				q++;
+			}
+			*exp10 += eneg ? -x : x;
+			p = q;
+		}
+	}
+	
+	return p;
+}
+
+/**
+ * Test whether strtod() could consume a character, independent of locale.
+ * @since 0.2
+ */
+static inline int
+ino_is_number_char(char c)
+{
+	return (unsigned)( c - '0' ) < 10 || (unsigned)( ( c | 0x20 ) - 'a' ) < 26 ||
+	       c == '+' || c == '-' || c == '.' || c == '(' || c == ')' || c == '_';
+}
+
+/**
+ * Convert with strtod() or strtof() under the "C" locale.
+ * @param str Start of the number.
+ * @param last End of the input.
+ * @param terminated 1 if the input is known to be zero terminated at last.
+ * @param single 1 to round to float with strtof(), 0 for strtod().
+ * @param end Filled with the position after the number.
+ * @param status Filled with INO_PARSE_OK, INO_PARSE_INVALID or INO_PARSE_RANGE.
+ * @return The value converted.
+ * @since 0.2
+ */
+static double
+ino_strtod_c(const char *str, const char *last, int terminated, int single, const char **end, int *status)
+{
+	char tmp[64];					/* terminated copy of a short number */
+	char *copy = NULL;		/* terminated copy of a long number */
+	const char *src = str;	/* string handed to strtod() */
+	char *e;							/* end of the number in src */
+	size_t n = 0;					/* bytes copied */
+	locale_t old = (locale_t)0;
+	int saved = errno;
+	double d;
+	
+	/* strtod() needs a terminated string, copy anything it could consume */
+	if ( !terminated )
+	{
+		while ( str + n < last && ino_is_number_char(str[n]) ) n++;
+		if ( n >= sizeof(tmp) && !( copy = (char *)malloc(n + 1) ) )
+		{
+			*end = str;
+			*status = INO_PARSE_INVALID;
+			return 0;
+		}
+		src = copy ? copy : tmp;
+		memcpy((char *)src, str, n);
+		((char *)src)[n] = '\0';
+	}
+	
+	pthread_once(&ino_c_locale_once, ino_c_locale_init);
+	if ( ino_c_locale ) old = uselocale(ino_c_locale);
+	errno = 0;
+	d = single ? strtof(src, &e) : strtod(src, &e);
+	*status = ( e == src ) ? INO_PARSE_INVALID : ( errno == ERANGE ? INO_PARSE_RANGE : INO_PARSE_OK );
+	if ( ino_c_locale ) uselocale(old);
+	errno = saved;
+	
+	*end = str + ( e - src );
+	free(copy);
+	
+	return d;
+}
+
+/**
+ * Parse a long, bounded by last.
+ * @since 0.2
+ */
+static const char *
+ino_parse_long_until(const char *str, const char *last, long *val, int *status)
+{
+	const char *p = ino_skip_space(str, last);
+	const char *q;
+	uint64_t m = 0;
+	uint64_t max = LONG_MAX;
+	int nd = 0;
+	int neg = 0;
+	
+	if ( p < last && ( *p == '+' || *p == '-' ) ) neg = ( *p++ == '-' );
+	q = p;
+	while ( p < last && *p == '0' ) p++;
+	p = ino_scan_digits(p, last, &m, &nd);
+	if ( p == q )
+	{
+		*val = 0;
+		*status = INO_PARSE_INVALID;
+		return str;
+	}
+	if ( neg ) max++;
+	if ( nd > 19 || m > max )
+	{
+		*val = neg ? LONG_MIN : LONG_MAX;
+		*status = INO_PARSE_RANGE;
+	}
+	else
+	{
+		*val = neg ? (long)( 0 - m ) : (long)m;
+		*status = INO_PARSE_OK;
+	}
+	
+	return p;
+}
+
+/**
+ * Parse a double, bounded by last.
+ * @since 0.2
+ */
+static const char *
+ino_parse_double_until(const char *str, const char *last, int terminated, double *val, int *status)
+{
+	const char *p = ino_skip_space(str, last);
+	const char *end;
+	uint64_t m;
+	int nd, neg;
+	long e;
+	
+	end = ino_scan_real(p, last, &m, &nd, &e, &neg);
+	if ( end == p )
+	{
+		*val = 0;
+		*status = INO_PARSE_INVALID;
+		return str;
+	}
+	if ( end && m == 0 && nd <= 19 )
+	{
+		*val = neg ? -0.0 : 0.0;
+		*status = INO_PARSE_OK;
+		return end;
+	}
+#if INO_PARSE_FAST_REAL
+	if ( end && nd <= 19 && m <= ( 1ULL << 53 ) )
+	{
+		/* shift surplus powers of ten into the mantissa while it stays exact */
+		while ( e > 22 && m <= ( 1ULL << 53 ) / 10 )
+		{
+			m *= 10;
+			e--;
+		}
+		if ( e >= -22 && e <= 22 )
+		{
+			double d = (double)m;
+			d = ( e < 0 ) ? d / ino_pow10[-e] : d * ino_pow10[e];
+			*val = neg ? -d : d;
+			*status = INO_PARSE_OK;
+			return end;
+		}
+	}
+#endif
+	*val = ino_strtod_c(p, last, terminated, 0, &end, status);
+	
+	return ( *status == INO_PARSE_INVALID ) ? str : end;
+}
+
+/**
+ * Parse a float, bounded by last.
+ * @since 0.2
+ */
+static const char *
+ino_parse_float_until(const char *str, const char *last, int terminated, float *val, int *status)
+{
+	const char *p = ino_skip_space(str, last);
+	const char *end;
+	uint64_t m;
+	int nd, neg;
+	long e;
+	
+	end = ino_scan_real(p, last, &m, &nd, &e, &neg);
+	if ( end == p )
+	{
+		*val = 0;
+		*status = INO_PARSE_INVALID;
+		return str;
+	}
+	if ( end && m == 0 && nd <= 19 )
+	{
+		*val = neg ? -0.0f : 0.0f;
+		*status = INO_PARSE_OK;
+		return end;
+	}
+#if INO_PARSE_FAST_REAL
+	if ( end && nd <= 19 && m <= ( 1ULL << 24 ) && e >= -10 && e <= 10 )
+	{
+		float f = (float)m;
+		f = ( e < 0 ) ? f / ino_pow10f[-e] : f * ino_pow10f[e];
+		*val = neg ? -f : f;
+		*status = INO_PARSE_OK;
+		return end;
+	}
+#endif
+	*val = (float)ino_strtod_c(p, last, terminated, 1, &end, status);
+	
+	return ( *status == INO_PARSE_INVALID ) ? str : end;
+}
+
+/**
+ * Parse a decimal long from a string without depending on the locale.
+ * Accepts optional leading white-space and sign, like strtol() in base 10,
+ * but converts eight digits at a time.
+ * @param str The string to parse.
+ * @param last End of the input, or NULL if str is zero terminated.
+ * @param val Filled with the value, clamped to LONG_MIN or LONG_MAX on overflow.
+ * @param status If not NULL, filled with INO_PARSE_OK, INO_PARSE_INVALID if
+ * there is no number, or INO_PARSE_RANGE on overflow.
+ * @return Position after the number, or str if there is no number.
+ * @since 0.2
+ */
+const char *
+ino_parse_long(const char *str, const char *last, long *val, int *status)
+{
+	int st;
+	
+	if ( !last ) last = str + strlen(str);
+	str = ino_parse_long_until(str, last, val, &st);
+	if ( status ) *status = st;
+	
+	return str;
+}
+
+/**
+ * Parse a decimal int from a string without depending on the locale.
+ * Works like ino_parse_long() with the value clamped to the range of int.
+ * @param str The string to parse.
+ * @param last End of the input, or NULL if str is zero terminated.
+ * @param val Filled with the value, clamped to INT_MIN or INT_MAX on overflow.
+ * @param status If not NULL, filled with INO_PARSE_OK, INO_PARSE_INVALID if
+ * there is no number, or INO_PARSE_RANGE on overflow.
+ * @return Position after the number, or str if there is no number.
+ * @since 0.2
+ */
+const char *
+ino_parse_int(const char *str, const char *last, int *val, int *status)
+{
+	long l;
+	int st;
+	
+	if ( !last ) last = str + strlen(str);
+	str = ino_parse_long_until(str, last, &l, &st);
+	if ( l > INT_MAX || l < INT_MIN )
+	{
+		l = ( l > INT_MAX ) ? INT_MAX : INT_MIN;
+		st = INO_PARSE_RANGE;
+	}
+	*val = (int)l;
+	if ( status ) *status = st;
+	
+	return str;
+}
+
+/**
+ * Parse a float from a string without depending on the locale.
+ * Accepts the same syntax as strtof() in the "C" locale and is correctly
+ * rounded.  Short decimal numbers take a fast path that avoids strtof().
+ * @param str The string to parse.
+ * @param last End of the input, or NULL if str is zero terminated.
+ * @param val Filled with the value.
+ * @param status If not NULL, filled with INO_PARSE_OK, INO_PARSE_INVALID if
+ * there is no number, or INO_PARSE_RANGE on overflow or underflow.
+ * @return Position after the number, or str if there is no number.
+ * @since 0.2
+ */
+const char *
+ino_parse_float(const char *str, const char *last, float *val, int *status)
+{
+	int terminated = ( last == NULL );
+	int st;
+	
+	if ( !last ) last = str + strlen(str);
+	str = ino_parse_float_until(str, last, terminated, val, &st);
+	if ( status ) *status = st;
+	
+	return str;
+}
+
+/**
+ * Parse a double from a string without depending on the locale.
+ * Accepts the same syntax as strtod() in the "C" locale and is correctly
+ * rounded.  Short decimal numbers take a fast path that avoids strtod().
+ * @param str The string to parse.
+ * @param last End of the input, or NULL if str is zero terminated.
+ * @param val Filled with the value.
+ * @param status If not NULL, filled with INO_PARSE_OK, INO_PARSE_INVALID if
+ * there is no number, or INO_PARSE_RANGE on overflow or underflow.
+ * @return Position after the number, or str if there is no number.
+ * @since 0.2
+ */
+const char *
+ino_parse_double(const char *str, const char *last, double *val, int *status)
+{
+	int terminated = ( last == NULL );
+	int st;
+	
+	if ( !last ) last = str + strlen(str);
+	str = ino_parse_double_until(str, last, terminated, val, &st);
+	if ( status ) *status = st;
+	
+	return str;
+}
+
+/**
+ * Cast white-space delimited string data to int by position in the string.
+ * Extract numeric value at position, "pos," in the string.  E.g., in order
+ * to extract an int at the beginning of the string, use pos = 0. In order
+ * to extract the second numeric value in the string, use pos = 1, etc.
+ * @param frame Frame of characters returned by ino_read().
+ * @param pos Position in the frame of numeric values, starting with zero.
+ * @return The integer read at the given position, or zero on error.
+ * @since 0.1
+ */
+int
+ino_cast_int(char *frame, int pos)
+{
+	int val = 0;
+	char *start = frame;
+	char *delims = " \t\r\n;|";
+	int len = strlen(frame);
+	int j = 0;
+
+	while ( j<pos && start < frame+len )
+	{
+		start = strpbrk(start,delims) + 1;
+		while( start < frame+len && strchr(delims,*start) )
 			start++;
 		j++;
 	}
 	if ( start < frame+len )
-		val = strtol(start, &end, 10);
+		ino_parse_int(start, NULL, &val, NULL);
 	
 	return val;
 }
@@ -338,7 +1704,6 @@ ino_cast_long(char *frame, int pos)
 {
 	long val = 0;
 	char *start = frame;
-	char *end = NULL;
 	char *delims = " \t\r\n;|";
 	int len = strlen(frame);
 	int j = 0;
@@ -351,7 +1716,7 @@ ino_cast_long(char *frame, int pos)
 		j++;
 	}
 	if ( start < frame+len )
-		val = strtol(start, &end, 10);
+		ino_parse_long(start, NULL, &val, NULL);
 
 	return val;
 }
@@ -371,7 +1736,6 @@ ino_cast_float(char *frame, int pos)
 {
 	float val = 0;
 	char *start = frame;
-	char *end = NULL;
 	char *delims = " \t\r\n;|";
 	int len = strlen(frame);
 	int j = 0;
@@ -384,7 +1748,7 @@ ino_cast_float(char *frame, int pos)
 		j++;
 	}
 	if ( start < frame+len )
-		val = strtof(start, &end);
+		ino_parse_float(start, NULL, &val, NULL);
 	
 	return val;
 }
@@ -404,7 +1768,6 @@ ino_cast_double(char *frame, int pos)
 {
 	double val = 0;
 	char *start = frame;
-	char *end = NULL;
 	char *delims = " \t\r\n;|";
 	int len = strlen(frame);
 	int j = 0;
@@ -417,288 +1780,926 @@ ino_cast_double(char *frame, int pos)
 		j++;
 	}
 	if ( start < frame+len )
-		val = strtod(start, &end);
+		ino_parse_double(start, NULL, &val, NULL);
 	
 	return val;
 }
 
+/* field delimiters recognized in character frames: " \t\r\n;|" */
+static const unsigned char ino_delims[256] = {
+	[' '] = 1, ['\t'] = 1, ['\r'] = 1, ['\n'] = 1, [';'] = 1, ['|'] = 1
+};
+
 /**
- * Read raw bytes from a raw Arduino serial connection.
- * Reads an exact number of raw bytes from the serial port into an array of
- * uint8_t.  Use this function for more complex or custom interpretation
- * of the bytes delivered.  The function requires an ino_connection_t object
- * created using ino_connection_raw().
- * @param cnx Pointer to ino_connection_t object from which to read data.
- * @param buf Pointer to the beginning of an array of uint8_t.
- * @param frame_size_bytes The exact number of bytes to read.
- * @return The number of bytes read, or -1 on error.
- * @since 0.1
+ * Skip delimiters up to the start of the next field.
+ * @param p Position in a zero terminated frame.
+ * @return Start of the next field, or NULL at the end of the frame.
+ * @since 0.2
  */
-int
-ino_read_raw(ino_connection_t *cnx, uint8_t *buf, int frame_size_bytes)
+static const char *
+ino_next_field(const char *p)
 {
-  int n = -1;		/* return number of bytes read or -1 on error */
+	while ( ino_delims[(unsigned char)*p] ) p++;
+	
+	return *p ? p : NULL;
+}
 
-	/* if connected */
-	if ( cnx && cnx->fd > -1 )
-	{
-		/* receive string from arduino */
-		n = read(cnx->fd, buf, frame_size_bytes);
+/**
+ * Skip the rest of a field up to the delimiter or terminator after it.
+ * @param p Position inside a field of a zero terminated frame.
+ * @return Position just after the field.
+ * @since 0.2
+ */
+static const char *
+ino_skip_field(const char *p)
+{
+	while ( *p && !ino_delims[(unsigned char)*p] ) p++;
+	
+	return p;
+}
+
+/**
+ * Index the fields of a delimited string in one pass.
+ * Records the offset of the first character of each field so any field can
+ * be converted later without rescanning the frame, e.g. with
+ * ino_parse_double(frame + offsets[i], NULL, &val, &status).  Fields are
+ * separated by runs of the same delimiters the ino_cast_*() functions use.
+ * @param frame Zero terminated frame of characters returned by ino_read().
+ * @param offsets Array filled with the byte offset of each field.
+ * @param max_fields Length of the offsets array.
+ * @return The number of fields indexed.
+ * @since 0.2
+ */
+int
+ino_split(const char *frame, int *offsets, int max_fields)
+{
+	const char *p = frame;	/* scan position */
+	int k = 0;							/* fields found */
+	
+	while ( k < max_fields && ( p = ino_next_field(p) ) )
+	{
+		offsets[k++] = p - frame;
+		p = ino_skip_field(p);
 	}
-	  
-  return n;
+	
+	return k;
 }
 
 /**
- * Read a single signed 16-bit integer from the given Arduino raw connection.
- * Reads 2 bytes from the serial port and converts them from network byte order
- * into host byte order and casts them to a signed 16-bit integer.  The 
- * corresponding Arduino library "send" function will send the integer byte by
- * byte in network byte order.  The function requires an ino_connection_t object
- * created using ino_connection_raw() with a 2 byte frame size.
- * @param cnx Pointer to ino_connection_t object from which to read data.
- * @return The int16_t read from the serial port.
- * @since 0.1
+ * Cast every field of a delimited string to int in one pass.
+ * Converts the fields in order into buf, scanning the frame only once, which
+ * is much faster than calling ino_cast_int() for each position.  Fields
+ * that are not numeric are stored as zero.
+ * @param frame Zero terminated frame of characters returned by ino_read().
+ * @param buf Array of int to receive the values.
+ * @param max_count Length of buf.
+ * @return The number of values stored in buf.
+ * @since 0.2
  */
-int16_t
-ino_read_int16(ino_connection_t *cnx)
+int
+ino_cast_ints(const char *frame, int *buf, int max_count)
 {
-  int n = 0;												/* total bytes received */
-  int j = 0;												/* loop indices */
-  ino_int16 tmp;										/* working tmp int */
-  int frame_size = 2;								/* number of bytes in frame */
-  unsigned char frame[frame_size];	/* frame buffer */
+	const char *p = frame;										/* scan position */
+	const char *last = frame + strlen(frame);	/* end of the frame */
+	int k = 0;																/* values stored */
+	
+	while ( k < max_count && ( p = ino_next_field(p) ) )
+	{
+		p = ino_parse_int(p, last, &buf[k++], NULL);
+		p = ino_skip_field(p);
+	}
+	
+	return k;
+}
 
-	/* init tmp to zero */
-	tmp.unsig = 0;
+/**
+ * Cast every field of a delimited string to long in one pass.
+ * Converts the fields in order into buf, scanning the frame only once, which
+ * is much faster than calling ino_cast_long() for each position.  Fields
+ * that are not numeric are stored as zero.
+ * @param frame Zero terminated frame of characters returned by ino_read().
+ * @param buf Array of long to receive the values.
+ * @param max_count Length of buf.
+ * @return The number of values stored in buf.
+ * @since 0.2
+ */
+int
+ino_cast_longs(const char *frame, long *buf, int max_count)
+{
+	const char *p = frame;										/* scan position */
+	const char *last = frame + strlen(frame);	/* end of the frame */
+	int k = 0;																/* values stored */
+	
+	while ( k < max_count && ( p = ino_next_field(p) ) )
+	{
+		p = ino_parse_long(p, last, &buf[k++], NULL);
+		p = ino_skip_field(p);
+	}
+	
+	return k;
+}
 
-	/* if connected */
-	if ( cnx && cnx->fd > -1 )
+/**
+ * Cast every field of a delimited string to float in one pass.
+ * Converts the fields in order into buf, scanning the frame only once, which
+ * is much faster than calling ino_cast_float() for each position.  Fields
+ * that are not numeric are stored as zero.
+ * @param frame Zero terminated frame of characters returned by ino_read().
+ * @param buf Array of float to receive the values.
+ * @param max_count Length of buf.
+ * @return The number of values stored in buf.
+ * @since 0.2
+ */
+int
+ino_cast_floats(const char *frame, float *buf, int max_count)
+{
+	const char *p = frame;										/* scan position */
+	const char *last = frame + strlen(frame);	/* end of the frame */
+	int status;						/* parse result, unused */
+	int k = 0;																/* values stored */
+	
+	while ( k < max_count && ( p = ino_next_field(p) ) )
 	{
-		/* prepare raw byte buffer */
-		memset(frame,0,frame_size);
-		/* receive frame of int bytes from arduino */
-		n = read(cnx->fd, frame, frame_size);
-		/* for each byte */
-		for(j=0; j<n; j++)
-		{
-			/* shift existing bits to make room for next byte */
-			tmp.unsig <<= 8;
-			/* add the bits of the next byte to the end of working tmp */
-			tmp.unsig |= frame[j];
-		}
+		p = ino_parse_float_until(p, last, 1, &buf[k++], &status);
+		p = ino_skip_field(p);
 	}
-		
-	/* return as signed int*/
-	return tmp.sig;
+	
+	return k;
 }
 
 /**
- * Read a single unsigned 16-bit integer from the given Arduino raw connection.
- * Reads 2 bytes from the serial port and converts them from network byte order
- * into host byte order and casts them to an unsigned 16-bit integer.  The 
- * corresponding Arduino library "send" function will send the integer byte by
- * byte in network byte order.  The function requires an ino_connection_t object
- * created using ino_connection_raw() with a 2 byte frame size.
- * @param cnx Pointer to ino_connection_t object from which to read data.
- * @return The uint16_t read from the serial port.
- * @since 0.1
+ * Cast every field of a delimited string to double in one pass.
+ * Converts the fields in order into buf, scanning the frame only once, which
+ * is much faster than calling ino_cast_double() for each position.  Fields
+ * that are not numeric are stored as zero.
+ * @param frame Zero terminated frame of characters returned by ino_read().
+ * @param buf Array of double to receive the values.
+ * @param max_count Length of buf.
+ * @return The number of values stored in buf.
+ * @since 0.2
  */
-uint16_t
-ino_read_uint16(ino_connection_t *cnx)
+int
+ino_cast_doubles(const char *frame, double *buf, int max_count)
 {
-  int n;														/* total bytes received */
-  int j=0;													/* loop indices */
-  ino_int16 tmp;										/* working tmp int */
-  int frame_size = 2;								/* number of bytes in frame */
-  unsigned char frame[frame_size];	/* frame buffer */
+	const char *p = frame;										/* scan position */
+	const char *last = frame + strlen(frame);	/* end of the frame */
+	int status;						/* parse result, unused */
+	int k = 0;																/* values stored */
+	
+	while ( k < max_count && ( p = ino_next_field(p) ) )
+	{
+		p = ino_parse_double_until(p, last, 1, &buf[k++], &status);
+		p = ino_skip_field(p);
+	}
+	
+	return k;
+}
 
-	/* init tmp to zero */
-	tmp.unsig = 0;
+/**
+ * Put the open port into or out of non-blocking mode.
+ * The current mode is remembered so repeated calls cost no syscalls.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @param nonblock 1 for non-blocking reads, 0 for blocking reads.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+static int
+ino_set_nonblock(ino_connection_t *cnx, int nonblock)
+{
+	int flags;
+	
+	if ( cnx->nonblock == nonblock ) return 0;
+	
+	flags = fcntl(cnx->fd, F_GETFL);
+	if ( flags == -1 ) return -1;
+	flags = nonblock ? ( flags | O_NONBLOCK ) : ( flags & ~O_NONBLOCK );
+	if ( fcntl(cnx->fd, F_SETFL, flags) == -1 ) return -1;
+	cnx->nonblock = nonblock;
+	
+	return 0;
+}
 
-	/* if connected */	
-	if ( cnx && cnx->fd > -1 )
+/**
+ * Grow the connection's input buffer so it can hold at least nbytes.
+ * Unread bytes are preserved.  The buffer never shrinks.
+ * @param cnx Pointer to ino_connection_t object.
+ * @param nbytes Capacity required in bytes.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+static int
+ino_reserve(ino_connection_t *cnx, int nbytes)
+{
+	uint8_t *buf;
+	
+	if ( nbytes <= cnx->in_size ) return 0;
+	
+	buf = (uint8_t *)realloc(cnx->in_buf, nbytes);
+	if ( !buf ) return -1;
+	cnx->in_buf = buf;
+	cnx->in_size = nbytes;
+	
+	return 0;
+}
+
+/**
+ * Grow the connection's scratch buffer so it can hold at least nbytes.
+ * The contents are not preserved.  The buffer never shrinks.
+ * @param cnx Pointer to ino_connection_t object.
+ * @param nbytes Capacity required in bytes.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+static int
+ino_reserve_scratch(ino_connection_t *cnx, int nbytes)
+{
+	if ( nbytes <= cnx->scratch_size ) return 0;
+	
+	free(cnx->scratch);
+	cnx->scratch = (uint8_t *)malloc(nbytes);
+	cnx->scratch_size = cnx->scratch ? nbytes : 0;
+	
+	return cnx->scratch ? 0 : -1;
+}
+
+/**
+ * Compute the absolute monotonic deadline timeout_us microseconds from now.
+ * @param deadline Filled with the deadline.
+ * @param timeout_us Microseconds from now.
+ * @since 0.2
+ */
+static void
+ino_deadline(struct timespec *deadline, long timeout_us)
+{
+	clock_gettime(CLOCK_MONOTONIC, deadline);
+	deadline->tv_sec += timeout_us / 1000000;
+	deadline->tv_nsec += ( timeout_us % 1000000 ) * 1000;
+	if ( deadline->tv_nsec >= 1000000000 )
 	{
-		/* prepare raw byte buffer */
-		memset(frame,0,frame_size);
-		/* receive frame of int bytes from arduino */
-		n = read(cnx->fd, frame, frame_size);
-		/* for each byte */
-		for(j=0; j<n; j++)
-		{
-			/* shift existing bits to make room for next byte */
-			tmp.unsig <<= 8;
-			/* add the bits of the next byte to the end of working tmp */
-			tmp.unsig |= frame[j];
-		}
+		deadline->tv_sec++;
+		deadline->tv_nsec -= 1000000000;
 	}
-		
-	/* return as unsigned int*/
-	return tmp.unsig;
 }
 
 /**
- * Read multiple signed 16-bit integers from an Arduino raw connection at once.
- * Reads 2 bytes per integer from the serial port and converts them from network
- * byte order into host byte order and casts them to signed 16-bit integers. 
- * The corresponding Arduino library "send" function will send the integer byte by
- * byte in network byte order.  The function requires an ino_connection_t object
- * created using ino_connection_raw() with a 2 bytes per integer frame size,
- * i.e., three 2-byte integers would require a connection frame size of 6 bytes.
- * @param cnx Pointer to ino_connection_t object from which to read data.
- * @param int_buf Pointer to the beginning of an array of int16_t.
- * @param int_count The number of integers to attempt reading <= array length.
- * @return The number of integers read from the serial port.
- * @since 0.1
+ * Compute the time left until a deadline.
+ * @param deadline Absolute monotonic deadline from ino_deadline().
+ * @param left Filled with the time remaining.
+ * @return 1 if time remains, 0 if the deadline has passed.
+ * @since 0.2
  */
-int
-ino_read_int16s(ino_connection_t *cnx, int16_t *int_buf, int int_count)
+static int
+ino_time_left(const struct timespec *deadline, struct timespec *left)
 {
-  int n;														/* total bytes received */
-  int i=0, k=0;											/* loop indices */
-  ino_int16 tmp;										/* working tmp int */
-  int frame_size = int_count * 2;		/* number of bytes in frame */
-  unsigned char frame[frame_size];	/* frame buffer */
+	struct timespec now;
+	
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	left->tv_sec = deadline->tv_sec - now.tv_sec;
+	left->tv_nsec = deadline->tv_nsec - now.tv_nsec;
+	if ( left->tv_nsec < 0 )
+	{
+		left->tv_sec--;
+		left->tv_nsec += 1000000000;
+	}
+	
+	return ( left->tv_sec > 0 || ( left->tv_sec == 0 && left->tv_nsec > 0 ) );
+}
 
-	/* if connected */	
-	if ( cnx && cnx->fd > -1 )
+/**
+ * Wait until the port is readable or a deadline passes.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @param deadline Absolute monotonic deadline, or NULL to wait forever.
+ * @return 1 if readable, 0 on timeout or hang up, -1 on error.
+ * @since 0.2
+ */
+static int
+ino_wait_readable(ino_connection_t *cnx, const struct timespec *deadline)
+{
+	struct pollfd pfd;			/* port to poll */
+	struct timespec left;		/* time left until deadline */
+	int n;
+	
+	pfd.fd = cnx->fd;
+	pfd.events = POLLIN;
+	do
 	{
-		/* prepare raw byte buffer */
-		memset(frame,0,frame_size);
-		/* receive frame of int's from arduino */
-		n = read(cnx->fd, frame, frame_size);
-		/* break sets of bytes up into integers */
-		/* for each set of bytes corresponding to an arduino int */
-		for(i=0; i<n; i+=2)
-		{
-			/* init tmp to zero */
-			tmp.unsig = 0;
-			/* add first byte */
-			tmp.unsig |= frame[i];
-			/* shift in the second byte */
-			tmp.unsig <<= 8;
-			tmp.unsig |= frame[i+1];
-			/* convert to signed int and add to int_buf */
-			int_buf[k++] = tmp.sig;
-		}
+		if ( deadline && !ino_time_left(deadline, &left) ) return 0;
+#ifdef __linux__
+		n = ppoll(&pfd, 1, deadline ? &left : NULL, NULL);
+#else
+		n = poll(&pfd, 1, deadline ? (int)( left.tv_sec * 1000 + ( left.tv_nsec + 999999 ) / 1000000 ) : -1);
+#endif
 	}
-	  
-  /* return the number of integers read */
-  return k;
+	while ( n < 0 && errno == EINTR );
+	
+	if ( n > 0 && !( pfd.revents & POLLIN ) ) n = 0;
+	
+	return n;
 }
 
 /**
- * Read multiple unsigned 16-bit integers from an Arduino raw connection at once.
- * Reads 2 bytes per integer from the serial port and converts them from network
- * byte order into host byte order and casts them to unsigned 16-bit integers. 
- * The corresponding Arduino library "send" function will send the integer byte by
- * byte in network byte order.  The function requires an ino_connection_t object
- * created using ino_connection_raw() with a 2 bytes per integer frame size,
- * i.e., three 2-byte integers would require a connection frame size of 6 bytes.
- * @param cnx Pointer to ino_connection_t object from which to read data.
- * @param int_buf Pointer to the beginning of an array of uint16_t.
- * @param int_count The number of integers to attempt reading <= array length.
- * @return The number of integers read from the serial port.
- * @since 0.1
+ * Fill the connection's input buffer until it holds at least nbytes.
+ * Reads as many bytes as the port has ready and the buffer can hold
+ * without blocking, so small typed reads are served from memory most of
+ * the time.  Outside exact mode a single blocking read() then asks for
+ * only the bytes still missing, so neither VMIN nor the VTIME timeout
+ * hold it back once they arrive; if some bytes are already buffered, it
+ * is only made once more arrive within the VTIME timeout.  In exact mode the port is polled until
+ * enough bytes arrive or the deadline passes.  Requests larger than the buffer
+ * are clamped to its capacity, which in line mode leaves out the last byte.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @param nbytes Number of unread bytes wanted in the buffer.
+ * @param exact 1 to poll for every byte, 0 for a VMIN/VTIME blocking read.
+ * @param deadline Absolute monotonic deadline for exact reads, or NULL.
+ * @return Number of unread bytes in the buffer, or -1 on error with none.
+ * @since 0.2
  */
-int
-ino_read_uint16s(ino_connection_t *cnx, uint16_t *int_buf, int int_count)
+static int
+ino_fill(ino_connection_t *cnx, int nbytes, int exact, const struct timespec *deadline)
 {
-  int n;														/* total bytes received */
-  int i=0, k=0;											/* loop indices */
-  ino_int16 tmp;										/* working tmp int */
-  int frame_size = int_count * 2;		/* number of bytes in frame */
-  unsigned char frame[frame_size];	/* frame buffer */
+	int n = 0;													/* bytes returned by read() */
+	int avail;													/* unread bytes buffered */
+	int size;														/* usable buffer size */
+	struct timespec until;							/* end of the VTIME wait for missing bytes */
 
-	/* if connected */	
-	if ( cnx && cnx->fd > -1 )
+	/* an outstanding frame view is consumed by the next read */
+	ino_release_view(cnx);
+	avail = cnx->in_tail - cnx->in_head;
+	/* line mode keeps a spare byte to zero terminate the last line in place */
+	size = ( cnx->lines && !cnx->raw ) ? cnx->in_size - 1 : cnx->in_size;
+	if ( nbytes > size ) nbytes = size;
+	
+	if ( avail < nbytes )
 	{
-		/* prepare raw byte buffer */
-		memset(frame,0,frame_size);
-		/* receive frame of int's from arduino */
-		n = read(cnx->fd, frame, frame_size);
-		/* break sets of bytes up into integers */
-		/* for each set of bytes corresponding to an arduino int */
-		for(i=0; i<n; i+=2)
-		{
-			/* init tmp to zero */
-			tmp.unsig = 0;
-			/* add first byte */
-			tmp.unsig |= frame[i];
-			/* shift in the second byte */
-			tmp.unsig <<= 8;
-			tmp.unsig |= frame[i+1];
-			/* take unsigned int value and add to int_buf */
-			int_buf[k++] = tmp.unsig;
+		/* slide unread bytes to the front if there is not enough room behind them */
+		if ( size - cnx->in_tail < nbytes - avail )
+		{
+			memmove(cnx->in_buf, cnx->in_buf + cnx->in_head, avail);
+			cnx->in_head = 0;
+			cnx->in_tail = avail;
+		}
+		if ( ino_set_nonblock(cnx, 1) == -1 ) return -1;
+		/* read whatever is ready until enough is buffered */
+		while ( avail < nbytes )
+		{
+			n = read(cnx->fd, cnx->in_buf + cnx->in_tail, size - cnx->in_tail);
+			if ( n > 0 )
+			{
+				cnx->in_tail += n;
+				avail += n;
+			}
+			else if ( n < 0 && errno == EINTR )
+				continue;
+			else if ( exact && n < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK ) )
+			{
+				/* nothing ready yet, wait for more bytes */
+				n = ino_wait_readable(cnx, deadline);
+				if ( n <= 0 ) break;
+			}
+			else
+				break;
+		}
+		
+		/* VTIME runs between bytes, so once some are in it bounds the wait for the rest */
+		if ( !exact && avail < nbytes && n != 0 && avail > 0 && cnx->raw_timeout > 0 )
+		{
+			ino_deadline(&until, cnx->raw_timeout * 100000L);
+			n = ino_wait_readable(cnx, &until);
+		}
+		/* block for just the missing bytes, the tty returns once the request is met */
+		if ( !exact && avail < nbytes && n != 0 )
+		{
+			if ( ino_set_nonblock(cnx, 0) == -1 ) return -1;
+			do
+				n = read(cnx->fd, cnx->in_buf + cnx->in_tail, nbytes - avail);
+			while ( n < 0 && errno == EINTR );
+			if ( n > 0 )
+			{
+				cnx->in_tail += n;
+				avail += n;
+			}
 		}
 	}
-	  
-  /* return the number of integers read */
-  return k;
+	
+	return ( n < 0 && avail == 0 ) ? -1 : avail;
 }
 
 /**
- * Read a single signed 32-bit integer from the given Arduino raw connection.
- * Reads 4 bytes from the serial port and converts them from network byte order
- * into host byte order and casts them to a signed 32-bit integer.  The 
- * corresponding Arduino library "send" function will send the integer byte by
- * byte in network byte order.  The function requires an ino_connection_t object
- * created using ino_connection_raw() with a 4 byte frame size.
- * @param cnx Pointer to ino_connection_t object from which to read data.
- * @return The int32_t read from the serial port.
- * @since 0.1
+ * Read bytes from the port straight into the caller's memory.
+ * Used for requests too large to be worth staging in the input buffer.  The
+ * blocking behaviour matches ino_fill().
+ * @param cnx Pointer to an open ino_connection_t object with an empty input buffer.
+ * @param dst Destination for the bytes read.
+ * @param nbytes Number of bytes to read.
+ * @param exact 1 to poll for every byte, 0 for VMIN/VTIME blocking reads.
+ * @param deadline Absolute monotonic deadline for exact reads, or NULL.
+ * @return Number of bytes read, or -1 on error with none.
+ * @since 0.2
  */
-int32_t
-ino_read_int32(ino_connection_t *cnx)
+static int
+ino_read_direct(ino_connection_t *cnx, uint8_t *dst, int nbytes, int exact, const struct timespec *deadline)
 {
-  int n;														/* total bytes received */
-  int j=0;													/* loop indices */
-  ino_int32 tmp;										/* working tmp int */
-  int frame_size = 4;								/* number of bytes in frame */
-  unsigned char frame[frame_size];	/* frame buffer */
-
-	/* init tmp to zero */
-	tmp.unsig = 0;
-
-	/* if connected */	
-	if ( cnx && cnx->fd > -1 )
+	int n = 0;		/* bytes returned by read() */
+	int k = 0;		/* bytes read so far */
+	
+	if ( ino_set_nonblock(cnx, exact) == -1 ) return -1;
+	while ( k < nbytes )
 	{
-		/* prepare raw byte buffer */
-		memset(frame,0,frame_size);
-		/* receive frame of int bytes from arduino */
-		n = read(cnx->fd, frame, frame_size);
-		/* for each byte */
-		for(j=0; j<n; j++)
+		n = read(cnx->fd, dst + k, nbytes - k);
+		if ( n > 0 )
 		{
-			/* shift existing bits to make room for next byte */
-			tmp.unsig <<= 8;
-			/* add the bits of the next byte to the end of working tmp */
-			tmp.unsig |= frame[j];
+			k += n;
+			/* another blocking read would wait past the VTIME timeout */
+			if ( !exact ) break;
+		}
+		else if ( n < 0 && errno == EINTR )
+			continue;
+		else if ( exact && n < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK ) )
+		{
+			/* nothing ready yet, wait for more bytes */
+			n = ino_wait_readable(cnx, deadline);
+			if ( n <= 0 ) break;
 		}
+		else
+			break;
 	}
-		
-	/* return as signed int*/
-	return tmp.sig;
+	
+	return ( n < 0 && k == 0 ) ? -1 : k;
 }
 
 /**
- * Read a single unsigned 32-bit integer from the given Arduino raw connection.
- * Reads 4 bytes from the serial port and converts them from network byte order
- * into host byte order and casts them to an unsigned 32-bit integer.  The 
+ * Copy bytes out of the connection's input buffer, refilling it as needed.
+ * Once the buffer is drained, a remainder at least as large as the buffer
+ * is read directly into dst, so bulk reads of any size cost one copy.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @param dst Destination for the bytes read.
+ * @param nbytes Number of bytes to read.
+ * @param exact 1 to poll for every byte, 0 for VMIN/VTIME blocking reads.
+ * @param deadline Absolute monotonic deadline for exact reads, or NULL.
+ * @return Number of bytes copied, or -1 on error before any were read.
+ * @since 0.2
+ */
+static int
+ino_take_until(ino_connection_t *cnx, uint8_t *dst, int nbytes, int exact, const struct timespec *deadline)
+{
+	int k = 0;		/* bytes copied so far */
+	int avail;		/* unread bytes buffered */
+	int last = 0;	/* 1 once a blocking read came up short */
+	
+	ino_release_view(cnx);
+	while ( k < nbytes && !last )
+	{
+		avail = cnx->in_tail - cnx->in_head;
+		if ( nbytes - k >= cnx->in_size )
+		{
+			if ( avail == 0 )
+			{
+				/* bypass the buffer for the rest of a large request */
+				avail = ino_read_direct(cnx, dst + k, nbytes - k, exact, deadline);
+				if ( avail <= 0 ) return k > 0 ? k : avail;
+				return k + avail;
+			}
+		}
+		else
+		{
+			avail = ino_fill(cnx, nbytes - k, exact, deadline);
+			if ( avail <= 0 ) return k > 0 ? k : avail;
+			/* outside exact mode a short fill means the read timed out */
+			last = ( !exact && avail < nbytes - k );
+			if ( avail > nbytes - k ) avail = nbytes - k;
+		}
+		memcpy(dst + k, cnx->in_buf + cnx->in_head, avail);
+		cnx->in_head += avail;
+		k += avail;
+		/* rewind an emptied buffer so the next fill has the whole capacity */
+		if ( cnx->in_head == cnx->in_tail ) cnx->in_head = cnx->in_tail = 0;
+	}
+	
+	return k;
+}
+
+/**
+ * Copy bytes out of the connection's input buffer in the connection's read mode.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @param dst Destination for the bytes read.
+ * @param nbytes Number of bytes to read.
+ * @return Number of bytes copied, or -1 on error before any were read.
+ * @since 0.2
+ */
+static int
+ino_take(ino_connection_t *cnx, uint8_t *dst, int nbytes)
+{
+	struct timespec deadline;
+	
+	if ( !cnx->exact ) return ino_take_until(cnx, dst, nbytes, 0, NULL);
+	if ( cnx->exact_timeout == INO_NO_TIMEOUT ) return ino_take_until(cnx, dst, nbytes, 1, NULL);
+	ino_deadline(&deadline, cnx->exact_timeout);
+	
+	return ino_take_until(cnx, dst, nbytes, 1, &deadline);
+}
+
+/**
+ * Read raw bytes from a raw Arduino serial connection.
+ * Reads an exact number of raw bytes from the serial port into an array of
+ * uint8_t.  Use this function for more complex or custom interpretation
+ * of the bytes delivered.  The function requires an ino_connection_t object
+ * created using ino_connection_raw().
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param buf Pointer to the beginning of an array of uint8_t.
+ * @param frame_size_bytes The exact number of bytes to read.
+ * @return The number of bytes read, or -1 on error.
+ * @since 0.1
+ */
+int
+ino_read_raw(ino_connection_t *cnx, uint8_t *buf, int frame_size_bytes)
+{
+  int n = -1;		/* return number of bytes read or -1 on error */
+
+	/* if connected */
+	if ( cnx && cnx->fd > -1 )
+	{
+		/* receive bytes from arduino through the input buffer */
+		n = ino_take(cnx, buf, frame_size_bytes);
+	}
+	  
+  return n;
+}
+
+/**
+ * Read a frame of raw bytes without copying it.
+ * Works like ino_read_raw(), but instead of copying the bytes into a caller
+ * supplied array it points view at the frame in place inside the connection's
+ * input buffer.  The view is read-only and stays valid until the next read
+ * function is called on the connection, ino_release_view() is called, or the
+ * connection is closed.  Use it to inspect a few fields or to forward the
+ * bytes elsewhere without paying for copies.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param view Pointer to ino_frame_view_t to point at the frame.
+ * @param frame_size_bytes The exact number of bytes to read.
+ * @return The number of bytes in the view, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_read_view(ino_connection_t *cnx, ino_frame_view_t *view, int frame_size_bytes)
+{
+	int n = -1;									/* return number of bytes in view or -1 on error */
+	struct timespec deadline;		/* when to give up in exact mode */
+	
+	view->data = NULL;
+	view->size = 0;
+	
+	/* if connected, with room for the whole frame in one piece */
+	if ( cnx && cnx->fd > -1 && ino_reserve(cnx, frame_size_bytes) == 0 )
+	{
+		if ( cnx->exact && cnx->exact_timeout != INO_NO_TIMEOUT )
+		{
+			ino_deadline(&deadline, cnx->exact_timeout);
+			n = ino_fill(cnx, frame_size_bytes, 1, &deadline);
+		}
+		else
+			n = ino_fill(cnx, frame_size_bytes, cnx->exact, NULL);
+		
+		if ( n > frame_size_bytes ) n = frame_size_bytes;
+		if ( n > 0 )
+		{
+			view->data = cnx->in_buf + cnx->in_head;
+			view->size = n;
+			cnx->view_size = n;
+		}
+	}
+	
+	return n;
+}
+
+/**
+ * Release the frame view handed out by the last ino_read_view() call.
+ * The view's bytes are consumed and the view must no longer be used.  This
+ * happens implicitly on the next read, so calling it is only needed to
+ * release the buffer space early.
+ * @param cnx Pointer to ino_connection_t object that handed out the view.
+ * @since 0.2
+ */
+void
+ino_release_view(ino_connection_t *cnx)
+{
+	if ( cnx && cnx->view_size > 0 )
+	{
+		cnx->in_head += cnx->view_size;
+		cnx->view_size = 0;
+		if ( cnx->in_head == cnx->in_tail ) cnx->in_head = cnx->in_tail = 0;
+	}
+}
+
+/**
+ * Switch a raw connection to or from exact-length reads.
+ * In exact mode every raw read function, including the typed integer readers,
+ * loops with poll() until all of its bytes have arrived or the timeout expires,
+ * instead of returning whatever a single read() yields.  Frames of any size,
+ * including those over the 255 byte VMIN limit of termios, are assembled
+ * reliably this way.  The timeout is in microseconds and covers each read
+ * call as a whole; use INO_NO_TIMEOUT to wait indefinitely.  The setting may
+ * be changed before or after the connection is opened.
+ * @param cnx Pointer to ino_connection_t object to configure.
+ * @param exact 1 to enable exact-length reads, 0 to restore VMIN/VTIME reads.
+ * @param timeout_us Microseconds to wait for a complete read, or INO_NO_TIMEOUT.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int
+ino_set_read_exact(ino_connection_t *cnx, int exact, long timeout_us)
+{
+	int error = -1;
+	struct termios toptions;
+	
+	if ( cnx && timeout_us >= 0 )
+	{
+		cnx->exact = exact ? 1 : 0;
+		cnx->exact_timeout = timeout_us;
+		error = 0;
+		
+		/* if connected, apply the matching VMIN/VTIME right away */
+		if ( cnx->raw && cnx->fd > -1 )
+		{
+			error = tcgetattr(cnx->fd, &toptions);
+			if ( error == 0 )
+			{
+				toptions.c_cc[VMIN]  = cnx->exact ? 1 : ( cnx->raw_size < 255 ? cnx->raw_size : 255 );
+				toptions.c_cc[VTIME] = cnx->exact ? 0 : cnx->raw_timeout;
+				error = tcsetattr(cnx->fd, TCSANOW, &toptions);
+			}
+		}
+	}
+	
+	return error;
+}
+
+/**
+ * Read an exact number of raw bytes, waiting at most the given deadline.
+ * Loops with poll() and read() until frame_size_bytes bytes have arrived or
+ * timeout_us microseconds have elapsed, whichever comes first, regardless of
+ * whether the connection is in exact mode.  A return value smaller than
+ * frame_size_bytes means the deadline expired or the port hung up with only
+ * that many bytes delivered; those bytes are still stored in buf.  Outside
+ * exact mode the port only reports readiness once VMIN bytes are waiting, so
+ * enable exact mode with ino_set_read_exact() to read partial frames.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param buf Pointer to the beginning of an array of uint8_t.
+ * @param frame_size_bytes The exact number of bytes to read.
+ * @param timeout_us Microseconds to wait for all bytes, or INO_NO_TIMEOUT.
+ * @return The number of bytes read, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_read_exact(ino_connection_t *cnx, uint8_t *buf, int frame_size_bytes, long timeout_us)
+{
+	int n = -1;									/* return number of bytes read or -1 on error */
+	struct timespec deadline;		/* when to give up */
+
+	/* if connected */
+	if ( cnx && cnx->fd > -1 )
+	{
+		if ( timeout_us == INO_NO_TIMEOUT )
+			n = ino_take_until(cnx, buf, frame_size_bytes, 1, NULL);
+		else
+		{
+			ino_deadline(&deadline, timeout_us);
+			n = ino_take_until(cnx, buf, frame_size_bytes, 1, &deadline);
+		}
+	}
+	
+	return n;
+}
+
+/**
+ * Switch a processed connection to or from user-space line splitting.
+ * Applies raw, byte-at-a-time port settings right away if the connection is
+ * open.  Text buffered in line mode is discarded when switching back to
+ * canonical mode.
+ * @param cnx Pointer to a processed ino_connection_t object to configure.
+ * @param lines 1 to split lines in user space, 0 to restore canonical mode.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int
+ino_set_line_mode(ino_connection_t *cnx, int lines)
+{
+	int error = -1;
+	struct termios toptions;
+	
+	if ( cnx )
+	{
+		cnx->lines = lines ? 1 : 0;
+		error = 0;
+		
+		/* if connected, turn kernel line processing off or back on right away */
+		if ( !cnx->raw && cnx->fd > -1 )
+		{
+			error = tcgetattr(cnx->fd, &toptions);
+			if ( error == 0 )
+			{
+				if ( cnx->lines )
+				{
+					toptions.c_lflag &= ~( ICANON | ECHOE | ECHOK | ECHOCTL | ECHOKE );
+					toptions.c_cc[VMIN]  = 1;
+					toptions.c_cc[VTIME] = 0;
+				}
+				else
+					toptions.c_lflag |= ( ICANON | ECHOE | ECHOK | ECHOCTL | ECHOKE );
+				error = tcsetattr(cnx->fd, TCSANOW, &toptions);
+			}
+			if ( error == 0 && !cnx->lines )
+			{
+				cnx->in_head = cnx->in_tail = cnx->view_size = 0;
+				error = ino_set_nonblock(cnx, 0);
+			}
+		}
+	}
+	
+	return error;
+}
+
+/**
+ * Tell whether a connection's port reports each byte as soon as it arrives.
+ * Raw connections outside exact mode only become readable once VMIN bytes,
+ * i.e. raw_size, are waiting, which a variable-length stream may never reach.
+ * @param cnx Pointer to an ino_connection_t object.
+ * @return 1 if the port wakes on every byte, 0 if not.
+ * @since 0.2
+ */
+static int
+ino_reads_bytewise(ino_connection_t *cnx)
+{
+	return cnx->raw ? ( cnx->exact || cnx->raw_size <= 1 ) : cnx->lines;
+}
+
+/**
+ * Find the first complete line, or delimited frame, in the input buffer,
+ * reading more as needed.  Each byte is scanned once, however many reads the
+ * line takes to arrive.  The buffer grows for long lines and always keeps one
+ * spare byte behind the line so it can be zero terminated in place.
+ * @param cnx Pointer to an open ino_connection_t object with no outstanding view.
+ * @param delim Byte ending each line, e.g. '\n'.
+ * @param deadline Absolute monotonic deadline, or NULL to wait forever.
+ * @return Length of the line from in_head including its delimiter,
+ *         INO_MAX_LINE_SIZE for a line that is too long, 0 if no line arrived
+ *         before the deadline or hang up, or -1 on error.
+ * @since 0.2
+ */
+static int
+ino_find_delim(ino_connection_t *cnx, int delim, const struct timespec *deadline)
+{
+	int scanned = 0;		/* unread bytes already searched */
+	int avail;					/* unread bytes buffered */
+	int n;
+	uint8_t *end;				/* delimiter */
+	
+	for ( ;; )
+	{
+		avail = cnx->in_tail - cnx->in_head;
+		end = (uint8_t *)memchr(cnx->in_buf + cnx->in_head + scanned, delim, avail - scanned);
+		if ( end ) return end - ( cnx->in_buf + cnx->in_head ) + 1;
+		scanned = avail;
+		
+		/* slide a partial line to the front once it blocks large reads */
+		if ( cnx->in_head > 0 && ( cnx->in_size - cnx->in_tail < cnx->in_size / 2 || avail >= INO_MAX_LINE_SIZE ) )
+		{
+			memmove(cnx->in_buf, cnx->in_buf + cnx->in_head, avail);
+			cnx->in_head = 0;
+			cnx->in_tail = avail;
+		}
+		if ( avail + 1 >= cnx->in_size )
+		{
+			n = cnx->in_size * 2 < INO_MAX_LINE_SIZE ? cnx->in_size * 2 : INO_MAX_LINE_SIZE + 1;
+			if ( ino_reserve(cnx, n > avail ? n : avail + 1) == -1 ) return -1;
+		}
+		if ( avail >= INO_MAX_LINE_SIZE ) return INO_MAX_LINE_SIZE;
+		
+		n = ino_fill(cnx, avail + 1, 1, deadline);
+		if ( n < 0 ) return -1;
+		if ( n <= avail ) return 0;
+	}
+}
+
+/**
+ * Read every complete line the Arduino has sent, up to max_lines.
+ * Lines are split in place inside the input buffer and consumed together at
+ * the next read, like a frame view.
+ * @param cnx Pointer to ino_connection_t object from which to read lines.
+ * @param lines Array of at least max_lines ino_line_t to fill.
+ * @param max_lines Maximum number of lines to return.
+ * @param timeout_us Microseconds to wait for the first line, or INO_NO_TIMEOUT.
+ * @return Number of lines read, 0 on timeout or hang up, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_read_lines(ino_connection_t *cnx, ino_line_t *lines, int max_lines, long timeout_us)
+{
+	int count = 0;							/* lines returned */
+	int used = 0;								/* bytes taken by the lines returned */
+	int len;										/* length of the next line including its new line */
+	int size;										/* length of the next line without its line ending */
+	char *line;
+	char *nl;										/* new line character */
+	struct timespec deadline;		/* when to give up */
+	
+	if ( !cnx || cnx->fd < 0 || !cnx->lines || cnx->raw || !lines || max_lines <= 0 || timeout_us < 0 ) return -1;
+	
+	ino_release_view(cnx);
+	if ( timeout_us == INO_NO_TIMEOUT )
+		len = ino_find_delim(cnx, '\n', NULL);
+	else
+	{
+		ino_deadline(&deadline, timeout_us);
+		len = ino_find_delim(cnx, '\n', &deadline);
+	}
+	
+	while ( len > 0 )
+	{
+		line = (char *)cnx->in_buf + cnx->in_head + used;
+		size = len;
+		if ( line[size - 1] == '\n' )
+		{
+			size--;
+			if ( size > 0 && line[size - 1] == '\r' ) size--;
+		}
+		line[size] = '\0';
+		lines[count].text = line;
+		lines[count].size = size;
+		count++;
+		used += len;
+		if ( count == max_lines ) break;
+		
+		/* take further lines only if they are already complete */
+		nl = (char *)memchr(line + len, '\n', cnx->in_tail - cnx->in_head - used);
+		len = nl ? nl - ( line + len ) + 1 : 0;
+	}
+	cnx->view_size = used;
+	
+	return len < 0 ? -1 : count;
+}
+
+/**
+ * Read a single signed 16-bit integer from the given Arduino raw connection.
+ * Reads 2 bytes from the serial port and converts them from network byte order
+ * into host byte order and casts them to a signed 16-bit integer.  The 
  * corresponding Arduino library "send" function will send the integer byte by
  * byte in network byte order.  The function requires an ino_connection_t object
- * created using ino_connection_raw() with a 4 byte frame size.
+ * created using ino_connection_raw() with a 2 byte frame size.
  * @param cnx Pointer to ino_connection_t object from which to read data.
- * @return The uint32_t read from the serial port.
+ * @return The int16_t read from the serial port.
  * @since 0.1
  */
-uint32_t
-ino_read_uint32(ino_connection_t *cnx)
+int16_t
+ino_read_int16(ino_connection_t *cnx)
+{
+  int n = 0;												/* total bytes received */
+  int j = 0;												/* loop indices */
+  ino_int16 tmp;										/* working tmp int */
+  int frame_size = 2;								/* number of bytes in frame */
+  unsigned char frame[frame_size];	/* frame buffer */
+
+	/* init tmp to zero */
+	tmp.unsig = 0;
+
+	/* if connected */
+	if ( cnx && cnx->fd > -1 )
+	{
+		/* prepare raw byte buffer */
+		memset(frame,0,frame_size);
+		/* receive frame of int bytes from arduino */
+		n = ino_take(cnx, frame, frame_size);
+		/* for each byte */
+		for(j=0; j<n; j++)
+		{
+			/* shift existing bits to make room for next byte */
+			tmp.unsig <<= 8;
+			/* add the bits of the next byte to the end of working tmp */
+			tmp.unsig |= frame[j];
+		}
+	}
+		
+	/* return as signed int*/
+	return tmp.sig;
+}
+
+/**
+ * Read a single unsigned 16-bit integer from the given Arduino raw connection.
+ * Reads 2 bytes from the serial port and converts them from network byte order
+ * into host byte order and casts them to an unsigned 16-bit integer.  The 
+ * corresponding Arduino library "send" function will send the integer byte by
+ * byte in network byte order.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 2 byte frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @return The uint16_t read from the serial port.
+ * @since 0.1
+ */
+uint16_t
+ino_read_uint16(ino_connection_t *cnx)
 {
   int n;														/* total bytes received */
   int j=0;													/* loop indices */
-  ino_int32 tmp;										/* working tmp int */
-  int frame_size = 4;								/* number of bytes in frame */
+  ino_int16 tmp;										/* working tmp int */
+  int frame_size = 2;								/* number of bytes in frame */
   unsigned char frame[frame_size];	/* frame buffer */
 
 	/* init tmp to zero */
@@ -707,291 +2708,4021 @@ ino_read_uint32(ino_connection_t *cnx)
 	/* if connected */	
 	if ( cnx && cnx->fd > -1 )
 	{
-		/* prepare raw byte buffer */
-		memset(frame,0,frame_size);
-		/* receive frame of int bytes from arduino */
-		n = read(cnx->fd, frame, frame_size);
-		/* for each byte */
-		for(j=0; j<n; j++)
+		/* prepare raw byte buffer */
+		memset(frame,0,frame_size);
+		/* receive frame of int bytes from arduino */
+		n = ino_take(cnx, frame, frame_size);
+		/* for each byte */
+		for(j=0; j<n; j++)
+		{
+			/* shift existing bits to make room for next byte */
+			tmp.unsig <<= 8;
+			/* add the bits of the next byte to the end of working tmp */
+			tmp.unsig |= frame[j];
+		}
+	}
+		
+	/* return as unsigned int*/
+	return tmp.unsig;
+}
+
+/**
+ * Read multiple signed 16-bit integers from an Arduino raw connection at once.
+ * Reads 2 bytes per integer from the serial port and converts them from network
+ * byte order into host byte order and casts them to signed 16-bit integers. 
+ * The corresponding Arduino library "send" function will send the integer byte by
+ * byte in network byte order.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 2 bytes per integer frame size,
+ * i.e., three 2-byte integers would require a connection frame size of 6 bytes.
+ * The bytes are received directly into int_buf and converted in place, so
+ * arrays of any size are read without extra copies or allocation.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param int_buf Pointer to the beginning of an array of int16_t.
+ * @param int_count The number of integers to attempt reading <= array length.
+ * @return The number of integers read from the serial port.
+ * @since 0.1
+ */
+int
+ino_read_int16s(ino_connection_t *cnx, int16_t *int_buf, int int_count)
+{
+  int n;														/* total bytes received */
+  int k=0;													/* integers decoded */
+  uint8_t *frame = (uint8_t *)int_buf;	/* bytes land in the caller's array */
+
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && int_count > 0 && int_count <= INT_MAX / 2 )
+	{
+		/* receive frame of int's from arduino straight into int_buf */
+		n = ino_take(cnx, frame, int_count * 2);
+		if ( n > 0 )
+		{
+			/* zero pad a partial trailing integer */
+			k = ( n + 1 ) / 2;
+			memset(frame + n, 0, k * 2 - n);
+			/* convert every integer from network byte order in place */
+			ino_betoh16s((uint16_t *)int_buf, frame, k);
+		}
+	}
+	  
+  /* return the number of integers read */
+  return k;
+}
+
+/**
+ * Read multiple unsigned 16-bit integers from an Arduino raw connection at once.
+ * Reads 2 bytes per integer from the serial port and converts them from network
+ * byte order into host byte order and casts them to unsigned 16-bit integers. 
+ * The corresponding Arduino library "send" function will send the integer byte by
+ * byte in network byte order.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 2 bytes per integer frame size,
+ * i.e., three 2-byte integers would require a connection frame size of 6 bytes.
+ * The bytes are received directly into int_buf and converted in place, so
+ * arrays of any size are read without extra copies or allocation.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param int_buf Pointer to the beginning of an array of uint16_t.
+ * @param int_count The number of integers to attempt reading <= array length.
+ * @return The number of integers read from the serial port.
+ * @since 0.1
+ */
+int
+ino_read_uint16s(ino_connection_t *cnx, uint16_t *int_buf, int int_count)
+{
+  int n;														/* total bytes received */
+  int k=0;													/* integers decoded */
+  uint8_t *frame = (uint8_t *)int_buf;	/* bytes land in the caller's array */
+
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && int_count > 0 && int_count <= INT_MAX / 2 )
+	{
+		/* receive frame of int's from arduino straight into int_buf */
+		n = ino_take(cnx, frame, int_count * 2);
+		if ( n > 0 )
+		{
+			/* zero pad a partial trailing integer */
+			k = ( n + 1 ) / 2;
+			memset(frame + n, 0, k * 2 - n);
+			/* convert every integer from network byte order in place */
+			ino_betoh16s((uint16_t *)int_buf, frame, k);
+		}
+	}
+	  
+  /* return the number of integers read */
+  return k;
+}
+
+/**
+ * Read a single signed 32-bit integer from the given Arduino raw connection.
+ * Reads 4 bytes from the serial port and converts them from network byte order
+ * into host byte order and casts them to a signed 32-bit integer.  The 
+ * corresponding Arduino library "send" function will send the integer byte by
+ * byte in network byte order.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 4 byte frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @return The int32_t read from the serial port.
+ * @since 0.1
+ */
+int32_t
+ino_read_int32(ino_connection_t *cnx)
+{
+  int n;														/* total bytes received */
+  int j=0;													/* loop indices */
+  ino_int32 tmp;										/* working tmp int */
+  int frame_size = 4;								/* number of bytes in frame */
+  unsigned char frame[frame_size];	/* frame buffer */
+
+	/* init tmp to zero */
+	tmp.unsig = 0;
+
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 )
+	{
+		/* prepare raw byte buffer */
+		memset(frame,0,frame_size);
+		/* receive frame of int bytes from arduino */
+		n = ino_take(cnx, frame, frame_size);
+		/* for each byte */
+		for(j=0; j<n; j++)
+		{
+			/* shift existing bits to make room for next byte */
+			tmp.unsig <<= 8;
+			/* add the bits of the next byte to the end of working tmp */
+			tmp.unsig |= frame[j];
+		}
+	}
+		
+	/* return as signed int*/
+	return tmp.sig;
+}
+
+/**
+ * Read a single unsigned 32-bit integer from the given Arduino raw connection.
+ * Reads 4 bytes from the serial port and converts them from network byte order
+ * into host byte order and casts them to an unsigned 32-bit integer.  The 
+ * corresponding Arduino library "send" function will send the integer byte by
+ * byte in network byte order.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 4 byte frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @return The uint32_t read from the serial port.
+ * @since 0.1
+ */
+uint32_t
+ino_read_uint32(ino_connection_t *cnx)
+{
+  int n;														/* total bytes received */
+  int j=0;													/* loop indices */
+  ino_int32 tmp;										/* working tmp int */
+  int frame_size = 4;								/* number of bytes in frame */
+  unsigned char frame[frame_size];	/* frame buffer */
+
+	/* init tmp to zero */
+	tmp.unsig = 0;
+
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 )
+	{
+		/* prepare raw byte buffer */
+		memset(frame,0,frame_size);
+		/* receive frame of int bytes from arduino */
+		n = ino_take(cnx, frame, frame_size);
+		/* for each byte */
+		for(j=0; j<n; j++)
+		{
+			/* shift existing bits to make room for next byte */
+			tmp.unsig <<= 8;
+			/* add the bits of the next byte to the end of working tmp */
+			tmp.unsig |= frame[j];
+		}
+	}
+		
+	/* return as unsigned int*/
+	return tmp.unsig;
+}
+
+/**
+ * Read multiple signed 32-bit integers from an Arduino raw connection at once.
+ * Reads 4 bytes per integer from the serial port and converts them from network
+ * byte order into host byte order and casts them to signed 32-bit integers. 
+ * The corresponding Arduino library "send" function will send the integer byte by
+ * byte in network byte order.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 4 bytes per integer frame size,
+ * i.e., three 4-byte integers would require a connection frame size of 12 bytes.
+ * The bytes are received directly into int_buf and converted in place, so
+ * arrays of any size are read without extra copies or allocation.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param int_buf Pointer to the beginning of an array of int32_t.
+ * @param int_count The number of integers to attempt reading <= array length.
+ * @return The number of integers read from the serial port.
+ * @since 0.1
+ */
+int
+ino_read_int32s(ino_connection_t *cnx, int32_t *int_buf, int int_count)
+{
+  int n;														/* total bytes received */
+  int k=0;													/* integers decoded */
+  uint8_t *frame = (uint8_t *)int_buf;	/* bytes land in the caller's array */
+
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && int_count > 0 && int_count <= INT_MAX / 4 )
+	{
+		/* receive frame of int's from arduino straight into int_buf */
+		n = ino_take(cnx, frame, int_count * 4);
+		if ( n > 0 )
+		{
+			/* zero pad a partial trailing integer */
+			k = ( n + 3 ) / 4;
+			memset(frame + n, 0, k * 4 - n);
+			/* convert every integer from network byte order in place */
+			ino_betoh32s((uint32_t *)int_buf, frame, k);
+		}
+	}
+	  
+  /* return the number of integers read */
+  return k;
+}
+
+/**
+ * Read multiple unsigned 32-bit integers from an Arduino raw connection at once.
+ * Reads 4 bytes per integer from the serial port and converts them from network
+ * byte order into host byte order and casts them to unsigned 32-bit integers. 
+ * The corresponding Arduino library "send" function will send the integer byte by
+ * byte in network byte order.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 4 bytes per integer frame size,
+ * i.e., three 4-byte integers would require a connection frame size of 12 bytes.
+ * The bytes are received directly into int_buf and converted in place, so
+ * arrays of any size are read without extra copies or allocation.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param int_buf Pointer to the beginning of an array of uint32_t.
+ * @param int_count The number of integers to attempt reading <= array length.
+ * @return The number of integers read from the serial port.
+ * @since 0.1
+ */
+int
+ino_read_uint32s(ino_connection_t *cnx, uint32_t *int_buf, int int_count)
+{
+  int n;														/* total bytes received */
+  int k=0;													/* integers decoded */
+  uint8_t *frame = (uint8_t *)int_buf;	/* bytes land in the caller's array */
+
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && int_count > 0 && int_count <= INT_MAX / 4 )
+	{
+		/* receive frame of int's from arduino straight into int_buf */
+		n = ino_take(cnx, frame, int_count * 4);
+		if ( n > 0 )
+		{
+			/* zero pad a partial trailing integer */
+			k = ( n + 3 ) / 4;
+			memset(frame + n, 0, k * 4 - n);
+			/* convert every integer from network byte order in place */
+			ino_betoh32s((uint32_t *)int_buf, frame, k);
+		}
+	}
+	  
+  /* return the number of integers read */
+  return k;
+}
+
+/**
+ * Read a single signed 64-bit integer from the given Arduino raw connection.
+ * Reads 8 bytes from the serial port and converts them from network byte order
+ * into host byte order and casts them to a signed 64-bit integer.  The 
+ * corresponding Arduino library "send" function will send the integer byte by
+ * byte in network byte order.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with an 8 byte frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @return The int64_t read from the serial port.
+ * @since 0.2
+ */
+int64_t
+ino_read_int64(ino_connection_t *cnx)
+{
+  int n;														/* total bytes received */
+  int j=0;													/* loop indices */
+  ino_int64 tmp;										/* working tmp int */
+  uint8_t frame[8];									/* frame buffer */
+
+	/* init tmp to zero */
+	tmp.unsig = 0;
+
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 )
+	{
+		/* receive frame of int bytes from arduino */
+		n = ino_take(cnx, frame, 8);
+		/* for each byte */
+		for(j=0; j<n; j++)
+		{
+			/* shift existing bits to make room for next byte */
+			tmp.unsig <<= 8;
+			/* add the bits of the next byte to the end of working tmp */
+			tmp.unsig |= frame[j];
+		}
+	}
+		
+	return tmp.sig;
+}
+
+/**
+ * Read a single unsigned 64-bit integer from the given Arduino raw connection.
+ * Reads 8 bytes from the serial port and converts them from network byte order
+ * into host byte order and casts them to an unsigned 64-bit integer.  The 
+ * corresponding Arduino library "send" function will send the integer byte by
+ * byte in network byte order.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with an 8 byte frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @return The uint64_t read from the serial port.
+ * @since 0.2
+ */
+uint64_t
+ino_read_uint64(ino_connection_t *cnx)
+{
+  int n;														/* total bytes received */
+  int j=0;													/* loop indices */
+  ino_int64 tmp;										/* working tmp int */
+  uint8_t frame[8];									/* frame buffer */
+
+	/* init tmp to zero */
+	tmp.unsig = 0;
+
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 )
+	{
+		/* receive frame of int bytes from arduino */
+		n = ino_take(cnx, frame, 8);
+		/* for each byte */
+		for(j=0; j<n; j++)
+		{
+			/* shift existing bits to make room for next byte */
+			tmp.unsig <<= 8;
+			/* add the bits of the next byte to the end of working tmp */
+			tmp.unsig |= frame[j];
+		}
+	}
+		
+	return tmp.unsig;
+}
+
+/**
+ * Read a single IEEE-754 single precision float from the given Arduino raw connection.
+ * Reads the 4 byte binary32 encoding in network byte order, so no text
+ * conversion is needed.  The corresponding Arduino library "send" function
+ * sends the value in that format.  The function requires an ino_connection_t
+ * object created using ino_connection_raw() with a 4 byte frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @return The float read from the serial port.
+ * @since 0.2
+ */
+float
+ino_read_float(ino_connection_t *cnx)
+{
+	ino_float32 tmp;		/* bits to value converter */
+	
+	tmp.bits = ino_read_uint32(cnx);
+	
+	return tmp.val;
+}
+
+/**
+ * Read a single IEEE-754 double precision float from the given Arduino raw connection.
+ * Reads the 8 byte binary64 encoding in network byte order, so no text
+ * conversion is needed.  The corresponding Arduino library "send" function
+ * sends the value in that format.  The function requires an ino_connection_t
+ * object created using ino_connection_raw() with an 8 byte frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @return The double read from the serial port.
+ * @since 0.2
+ */
+double
+ino_read_double(ino_connection_t *cnx)
+{
+	ino_float64 tmp;		/* bits to value converter */
+	
+	tmp.bits = ino_read_uint64(cnx);
+	
+	return tmp.val;
+}
+
+/**
+ * Read multiple signed 64-bit integers from an Arduino raw connection at once.
+ * Reads 8 bytes per value from the serial port and converts them from network
+ * byte order into host byte order.  The bytes are received directly into
+ * int_buf and converted in place, so arrays of any size are read without extra
+ * copies or allocation.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 8 bytes per value frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param int_buf Pointer to the beginning of an array of int64_t.
+ * @param int_count The number of values to attempt reading <= array length.
+ * @return The number of values read from the serial port.
+ * @since 0.2
+ */
+int
+ino_read_int64s(ino_connection_t *cnx, int64_t *int_buf, int int_count)
+{
+  int n;														/* total bytes received */
+  int k=0;													/* values decoded */
+  uint8_t *frame = (uint8_t *)int_buf;	/* bytes land in the caller's array */
+
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && int_count > 0 && int_count <= INT_MAX / 8 )
+	{
+		/* receive frame of values from arduino straight into int_buf */
+		n = ino_take(cnx, frame, int_count * 8);
+		if ( n > 0 )
+		{
+			/* zero pad a partial trailing value */
+			k = ( n + 7 ) / 8;
+			memset(frame + n, 0, k * 8 - n);
+			/* convert every value from network byte order in place */
+			ino_betoh64s((uint64_t *)int_buf, frame, k);
+		}
+	}
+	  
+  /* return the number of values read */
+  return k;
+}
+
+/**
+ * Read multiple unsigned 64-bit integers from an Arduino raw connection at once.
+ * Reads 8 bytes per value from the serial port and converts them from network
+ * byte order into host byte order.  The bytes are received directly into
+ * int_buf and converted in place, so arrays of any size are read without extra
+ * copies or allocation.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 8 bytes per value frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param int_buf Pointer to the beginning of an array of uint64_t.
+ * @param int_count The number of values to attempt reading <= array length.
+ * @return The number of values read from the serial port.
+ * @since 0.2
+ */
+int
+ino_read_uint64s(ino_connection_t *cnx, uint64_t *int_buf, int int_count)
+{
+  int n;														/* total bytes received */
+  int k=0;													/* values decoded */
+  uint8_t *frame = (uint8_t *)int_buf;	/* bytes land in the caller's array */
+
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && int_count > 0 && int_count <= INT_MAX / 8 )
+	{
+		/* receive frame of values from arduino straight into int_buf */
+		n = ino_take(cnx, frame, int_count * 8);
+		if ( n > 0 )
+		{
+			/* zero pad a partial trailing value */
+			k = ( n + 7 ) / 8;
+			memset(frame + n, 0, k * 8 - n);
+			/* convert every value from network byte order in place */
+			ino_betoh64s((uint64_t *)int_buf, frame, k);
+		}
+	}
+	  
+  /* return the number of values read */
+  return k;
+}
+
+/**
+ * Read multiple IEEE-754 single precision floats from an Arduino raw connection at once.
+ * Reads 4 bytes per value from the serial port and converts them from network
+ * byte order into host byte order.  The bytes are received directly into
+ * buf and converted in place, so arrays of any size are read without extra
+ * copies or allocation.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 4 bytes per value frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param buf Pointer to the beginning of an array of float.
+ * @param count The number of values to attempt reading <= array length.
+ * @return The number of values read from the serial port.
+ * @since 0.2
+ */
+int
+ino_read_floats(ino_connection_t *cnx, float *buf, int count)
+{
+  int n;														/* total bytes received */
+  int k=0;													/* values decoded */
+  uint8_t *frame = (uint8_t *)buf;	/* bytes land in the caller's array */
+
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && count > 0 && count <= INT_MAX / 4 )
+	{
+		/* receive frame of values from arduino straight into buf */
+		n = ino_take(cnx, frame, count * 4);
+		if ( n > 0 )
+		{
+			/* zero pad a partial trailing value */
+			k = ( n + 3 ) / 4;
+			memset(frame + n, 0, k * 4 - n);
+			/* convert every value from network byte order in place */
+			ino_betoh32s((uint32_t *)buf, frame, k);
+		}
+	}
+	  
+  /* return the number of values read */
+  return k;
+}
+
+/**
+ * Read multiple IEEE-754 double precision floats from an Arduino raw connection at once.
+ * Reads 8 bytes per value from the serial port and converts them from network
+ * byte order into host byte order.  The bytes are received directly into
+ * buf and converted in place, so arrays of any size are read without extra
+ * copies or allocation.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 8 bytes per value frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param buf Pointer to the beginning of an array of double.
+ * @param count The number of values to attempt reading <= array length.
+ * @return The number of values read from the serial port.
+ * @since 0.2
+ */
+int
+ino_read_doubles(ino_connection_t *cnx, double *buf, int count)
+{
+  int n;														/* total bytes received */
+  int k=0;													/* values decoded */
+  uint8_t *frame = (uint8_t *)buf;	/* bytes land in the caller's array */
+
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && count > 0 && count <= INT_MAX / 8 )
+	{
+		/* receive frame of values from arduino straight into buf */
+		n = ino_take(cnx, frame, count * 8);
+		if ( n > 0 )
+		{
+			/* zero pad a partial trailing value */
+			k = ( n + 7 ) / 8;
+			memset(frame + n, 0, k * 8 - n);
+			/* convert every value from network byte order in place */
+			ino_betoh64s((uint64_t *)buf, frame, k);
+		}
+	}
+	  
+  /* return the number of values read */
+  return k;
+}
+
+/*
+ * Delta streams.  Slowly changing samples are sent as the difference from the
+ * previous sample, wrapped to the sample width, zigzag mapped so small negative
+ * differences stay small, and written as little endian base 128 varints of 7
+ * bits per byte with the top bit marking a continuation.  The first sample of
+ * each array is sent as its difference from zero.  Runs of eight one-byte
+ * differences, the common case for sensor data, are recognised with a single
+ * 64-bit test and decoded without per-byte branches.
+ */
+
+/**
+ * Decode complete delta varints into 16-bit samples.
+ * @param dst Destination for the samples.
+ * @param count Maximum number of samples to decode.
+ * @param src Encoded bytes.
+ * @param nbytes Number of bytes in src.
+ * @param prev Previous sample, updated.
+ * @param used Filled with the number of bytes consumed.
+ * @return Number of samples decoded, or -1 on a malformed varint.
+ * @since 0.2
+ */
+static int
+ino_delta16_run(int16_t *dst, int count, const uint8_t *src, int nbytes, uint16_t *prev, int *used)
+{
+	uint64_t w;					/* eight encoded bytes */
+	uint16_t p = *prev;
+	uint32_t z;					/* zigzag difference */
+	int i = 0, k = 0, j, shift;
+	
+	while ( k < count && i < nbytes )
+	{
+		if ( k + 8 <= count && i + 8 <= nbytes )
+		{
+			memcpy(&w, src + i, 8);
+			if ( !( w & 0x8080808080808080ULL ) )
+			{
+				for(j=0; j<8; j++)
+				{
+					z = src[i + j];
+					p = (uint16_t)( p + ( ( z >> 1 ) ^ -( z & 1 ) ) );
+					dst[k + j] = (int16_t)p;
+				}
+				i += 8;
+				k += 8;
+				continue;
+			}
+		}
+		
+		/* one varint, stop at an incomplete one */
+		z = 0;
+		for(j=i, shift=0; j<nbytes && ( src[j] & 0x80 ); j++, shift+=7)
+		{
+			if ( shift > 7 ) return -1;
+			z |= (uint32_t)( src[j] & 0x7F ) << shift;
+		}
+		if ( j == nbytes ) break;
+		z |= (uint32_t)src[j] << shift;
+		p = (uint16_t)( p + ( ( z >> 1 ) ^ -( z & 1 ) ) );
+		dst[k++] = (int16_t)p;
+		i = j + 1;
+	}
+	
+	*prev = p;
+	*used = i;
+	
+	return k;
+}
+
+/**
+ * Decode complete delta varints into 32-bit samples.
+ * @param dst Destination for the samples.
+ * @param count Maximum number of samples to decode.
+ * @param src Encoded bytes.
+ * @param nbytes Number of bytes in src.
+ * @param prev Previous sample, updated.
+ * @param used Filled with the number of bytes consumed.
+ * @return Number of samples decoded, or -1 on a malformed varint.
+ * @since 0.2
+ */
+static int
+ino_delta32_run(int32_t *dst, int count, const uint8_t *src, int nbytes, uint32_t *prev, int *used)
+{
+	uint64_t w;					/* eight encoded bytes */
+	uint32_t p = *prev;
+	uint32_t z;					/* zigzag difference */
+	int i = 0, k = 0, j, shift;
+	
+	while ( k < count && i < nbytes )
+	{
+		if ( k + 8 <= count && i + 8 <= nbytes )
+		{
+			memcpy(&w, src + i, 8);
+			if ( !( w & 0x8080808080808080ULL ) )
+			{
+				for(j=0; j<8; j++)
+				{
+					z = src[i + j];
+					p += ( z >> 1 ) ^ -( z & 1 );
+					dst[k + j] = (int32_t)p;
+				}
+				i += 8;
+				k += 8;
+				continue;
+			}
+		}
+		
+		/* one varint, stop at an incomplete one */
+		z = 0;
+		for(j=i, shift=0; j<nbytes && ( src[j] & 0x80 ); j++, shift+=7)
+		{
+			if ( shift > 21 ) return -1;
+			z |= (uint32_t)( src[j] & 0x7F ) << shift;
+		}
+		if ( j == nbytes ) break;
+		z |= (uint32_t)src[j] << shift;
+		p += ( z >> 1 ) ^ -( z & 1 );
+		dst[k++] = (int32_t)p;
+		i = j + 1;
+	}
+	
+	*prev = p;
+	*used = i;
+	
+	return k;
+}
+
+/**
+ * Decode an array of 16-bit samples sent as a delta stream.
+ * @param dst Destination for count samples.
+ * @param count The number of samples to decode.
+ * @param src Encoded bytes, e.g. the payload of a frame.
+ * @param nbytes Number of bytes in src.
+ * @return Number of bytes consumed, or -1 if src is malformed or too short.
+ * @since 0.2
+ */
+int
+ino_decode_delta_int16s(int16_t *dst, int count, const uint8_t *src, int nbytes)
+{
+	uint16_t prev = 0;
+	int used = 0;
+	
+	if ( count < 0 || ino_delta16_run(dst, count, src, nbytes, &prev, &used) != count ) return -1;
+	
+	return used;
+}
+
+/**
+ * Decode an array of 32-bit samples sent as a delta stream.
+ * @param dst Destination for count samples.
+ * @param count The number of samples to decode.
+ * @param src Encoded bytes, e.g. the payload of a frame.
+ * @param nbytes Number of bytes in src.
+ * @return Number of bytes consumed, or -1 if src is malformed or too short.
+ * @since 0.2
+ */
+int
+ino_decode_delta_int32s(int32_t *dst, int count, const uint8_t *src, int nbytes)
+{
+	uint32_t prev = 0;
+	int used = 0;
+	
+	if ( count < 0 || ino_delta32_run(dst, count, src, nbytes, &prev, &used) != count ) return -1;
+	
+	return used;
+}
+
+/**
+ * Read an array of samples sent as a delta stream, 16 or 32 bits wide.
+ * Decodes straight out of the input buffer, refilling it in the connection's
+ * read mode until every sample has arrived.  The stream's length is not known
+ * up front, so the port must wake on every byte.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @param buf Destination for count samples.
+ * @param count The number of samples to read.
+ * @param wide 1 for int32_t samples, 0 for int16_t samples.
+ * @return The number of samples read, or -1 on malformed data or if the port
+ *         waits for VMIN bytes.
+ * @since 0.2
+ */
+static int
+ino_read_deltas(ino_connection_t *cnx, void *buf, int count, int wide)
+{
+	int k = 0;									/* samples decoded */
+	int n;											/* samples decoded from the buffer */
+	int used;										/* bytes consumed */
+	int avail;									/* unread bytes buffered */
+	uint16_t prev16 = 0;
+	uint32_t prev32 = 0;
+	struct timespec deadline;		/* when to give up in exact mode */
+	
+	/* the last few bytes of the stream may never make up VMIN */
+	if ( !ino_reads_bytewise(cnx) )
+	{
+		errno = EINVAL;
+		return -1;
+	}
+	
+	if ( cnx->exact && cnx->exact_timeout != INO_NO_TIMEOUT ) ino_deadline(&deadline, cnx->exact_timeout);
+	ino_release_view(cnx);
+	while ( k < count )
+	{
+		avail = cnx->in_tail - cnx->in_head;
+		if ( wide )
+			n = ino_delta32_run((int32_t *)buf + k, count - k, cnx->in_buf + cnx->in_head, avail, &prev32, &used);
+		else
+			n = ino_delta16_run((int16_t *)buf + k, count - k, cnx->in_buf + cnx->in_head, avail, &prev16, &used);
+		if ( n < 0 ) return -1;
+		k += n;
+		cnx->in_head += used;
+		avail -= used;
+		if ( k == count ) break;
+		
+		/* wait for at least one more byte to finish the next sample */
+		n = ino_fill(cnx, avail + 1, cnx->exact,
+			cnx->exact && cnx->exact_timeout != INO_NO_TIMEOUT ? &deadline : NULL);
+		if ( n <= avail ) break;
+	}
+	if ( cnx->in_head == cnx->in_tail ) cnx->in_head = cnx->in_tail = 0;
+	
+	return k;
+}
+
+/**
+ * Read multiple signed 16-bit integers sent as a delta stream.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param int_buf Pointer to the beginning of an array of int16_t.
+ * @param int_count The number of integers to read.
+ * @return The number of integers read, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_read_delta_int16s(ino_connection_t *cnx, int16_t *int_buf, int int_count)
+{
+	int k = -1;		/* return integers read or -1 on error */
+	
+	/* if connected */
+	if ( cnx && cnx->fd > -1 && int_count >= 0 )
+		k = ino_read_deltas(cnx, int_buf, int_count, 0);
+	
+	return k;
+}
+
+/**
+ * Read multiple signed 32-bit integers sent as a delta stream.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param int_buf Pointer to the beginning of an array of int32_t.
+ * @param int_count The number of integers to read.
+ * @return The number of integers read, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_read_delta_int32s(ino_connection_t *cnx, int32_t *int_buf, int int_count)
+{
+	int k = -1;		/* return integers read or -1 on error */
+	
+	/* if connected */
+	if ( cnx && cnx->fd > -1 && int_count >= 0 )
+		k = ino_read_deltas(cnx, int_buf, int_count, 1);
+	
+	return k;
+}
+
+/**
+ * Unpack count values of bits width from a big endian bit stream.
+ * @param dst Destination for count values.
+ * @param count The number of values to unpack.
+ * @param src Packed bytes, the first value in the most significant bits.
+ * @param nbytes Number of bytes in src.
+ * @param bits Width of each value, 1 to 16.
+ * @return Number of bytes consumed, or -1 if bits is out of range or src is too short.
+ * @since 0.2
+ */
+int
+ino_unpack_uint16s(uint16_t *dst, int count, const uint8_t *src, int nbytes, int bits)
+{
+	long pos = 0;				/* bit offset of the next value */
+	long size;					/* packed size in bytes */
+	uint64_t w;					/* 64 bits starting at the byte holding the value */
+	int i = 0, j;
+	
+	if ( count < 0 || bits < 1 || bits > 16 ) return -1;
+	size = INO_PACKED_SIZE(count, bits);
+	if ( size > INT_MAX || size > nbytes ) return -1;
+	
+	/* every value lies in the 8 bytes starting at its first byte, one unaligned load each */
+	for(; i<count && ( pos >> 3 ) + 8 <= size; i++, pos+=bits)
+	{
+		memcpy(&w, src + ( pos >> 3 ), 8);
+#if !INO_HOST_BIG_ENDIAN
+		w = __builtin_bswap64(w);
+#endif
+		dst[i] = (uint16_t)( ( w << ( pos & 7 ) ) >> ( 64 - bits ) );
+	}
+	/* the last few values without reading past the end */
+	for(; i<count; i++, pos+=bits)
+	{
+		w = 0;
+		for(j=0; j<3 && ( pos >> 3 ) + j < size; j++)
+			w |= (uint64_t)src[( pos >> 3 ) + j] << ( 56 - 8 * j );
+		dst[i] = (uint16_t)( ( w << ( pos & 7 ) ) >> ( 64 - bits ) );
+	}
+	
+	return (int)size;
+}
+
+/**
+ * Read multiple unsigned integers bit-packed to a width below 16 bits.
+ * The packed bytes are read into the connection's scratch buffer and
+ * unpacked into buf.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param buf Pointer to the beginning of an array of uint16_t.
+ * @param count The number of integers to read.
+ * @param bits Width of each integer, 1 to 16.
+ * @return The number of integers read, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_read_packed(ino_connection_t *cnx, uint16_t *buf, int count, int bits)
+{
+	int n;						/* bytes received */
+	int k = -1;				/* return integers read or -1 on error */
+	long size;				/* packed size in bytes */
+	
+	/* if connected */
+	if ( cnx && cnx->fd > -1 && count >= 0 && bits >= 1 && bits <= 16 )
+	{
+		size = INO_PACKED_SIZE(count, bits);
+		if ( size == 0 ) return 0;
+		/* the scratch buffer and reads are sized in int */
+		if ( size > INT_MAX ) return -1;
+		if ( ino_reserve_scratch(cnx, size) == -1 ) return -1;
+		n = ino_take(cnx, cnx->scratch, size);
+		if ( n > 0 )
+		{
+			/* only integers whose bits all arrived */
+			k = (int)( (long)n * 8 / bits );
+			if ( k > count ) k = count;
+			ino_unpack_uint16s(buf, k, cnx->scratch, n, bits);
+		}
+		else
+			k = n;
+	}
+	
+	return k;
+}
+
+/*
+ * Bulk byte order conversion.  Every integer on the wire is big endian, so
+ * on little endian hosts each 2, 4 or 8 byte group has to be reversed.  The
+ * kernels below work on raw bytes, accept dst == src, and are picked once
+ * per process from the best instruction set the CPU supports.
+ */
+typedef void (*ino_swap_fn)(uint8_t *dst, const uint8_t *src, int count);
+
+static void
+ino_swap16_scalar(uint8_t *dst, const uint8_t *src, int count)
+{
+	uint8_t b0, b1;
+	int k;
+	
+	for(k=0; k<count; k++, src+=2, dst+=2)
+	{
+		b0 = src[0];
+		b1 = src[1];
+		dst[0] = b1;
+		dst[1] = b0;
+	}
+}
+
+static void
+ino_swap32_scalar(uint8_t *dst, const uint8_t *src, int count)
+{
+	uint8_t b0, b1, b2, b3;
+	int k;
+	
+	for(k=0; k<count; k++, src+=4, dst+=4)
+	{
+		b0 = src[0];
+		b1 = src[1];
+		b2 = src[2];
+		b3 = src[3];
+		dst[0] = b3;
+		dst[1] = b2;
+		dst[2] = b1;
+		dst[3] = b0;
+	}
+}
+
+static void
+ino_swap64_scalar(uint8_t *dst, const uint8_t *src, int count)
+{
+	uint8_t b[8];
+	int j, k;
+	
+	for(k=0; k<count; k++, src+=8, dst+=8)
+	{
+		for(j=0; j<8; j++) b[j] = src[j];
+		for(j=0; j<8; j++) dst[j] = b[7-j];
+	}
+}
+
+#if defined(INO_SWAP_X86)
+__attribute__((target("ssse3"))) static void
+ino_swap16_ssse3(uint8_t *dst, const uint8_t *src, int count)
+{
+	const __m128i mask = _mm_setr_epi8(1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14);
+	__m128i v;
+	int k;
+	
+	for(k=0; k+8<=count; k+=8)
+	{
+		v = _mm_loadu_si128((const __m128i *)(src + k*2));
+		_mm_storeu_si128((__m128i *)(dst + k*2), _mm_shuffle_epi8(v, mask));
+	}
+	ino_swap16_scalar(dst + k*2, src + k*2, count - k);
+}
+
+__attribute__((target("ssse3"))) static void
+ino_swap32_ssse3(uint8_t *dst, const uint8_t *src, int count)
+{
+	const __m128i mask = _mm_setr_epi8(3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12);
+	__m128i v;
+	int k;
+	
+	for(k=0; k+4<=count; k+=4)
+	{
+		v = _mm_loadu_si128((const __m128i *)(src + k*4));
+		_mm_storeu_si128((__m128i *)(dst + k*4), _mm_shuffle_epi8(v, mask));
+	}
+	ino_swap32_scalar(dst + k*4, src + k*4, count - k);
+}
+
+__attribute__((target("ssse3"))) static void
+ino_swap64_ssse3(uint8_t *dst, const uint8_t *src, int count)
+{
+	const __m128i mask = _mm_setr_epi8(7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8);
+	__m128i v;
+	int k;
+	
+	for(k=0; k+2<=count; k+=2)
+	{
+		v = _mm_loadu_si128((const __m128i *)(src + k*8));
+		_mm_storeu_si128((__m128i *)(dst + k*8), _mm_shuffle_epi8(v, mask));
+	}
+	ino_swap64_scalar(dst + k*8, src + k*8, count - k);
+}
+
+__attribute__((target("avx2"))) static void
+ino_swap16_avx2(uint8_t *dst, const uint8_t *src, int count)
+{
+	const __m256i mask = _mm256_setr_epi8(1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14,
+	                                      1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14);
+	__m256i v;
+	int k;
+	
+	for(k=0; k+16<=count; k+=16)
+	{
+		v = _mm256_loadu_si256((const __m256i *)(src + k*2));
+		_mm256_storeu_si256((__m256i *)(dst + k*2), _mm256_shuffle_epi8(v, mask));
+	}
+	ino_swap16_ssse3(dst + k*2, src + k*2, count - k);
+}
+
+__attribute__((target("avx2"))) static void
+ino_swap32_avx2(uint8_t *dst, const uint8_t *src, int count)
+{
+	const __m256i mask = _mm256_setr_epi8(3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12,
+	                                      3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12);
+	__m256i v;
+	int k;
+	
+	for(k=0; k+8<=count; k+=8)
+	{
+		v = _mm256_loadu_si256((const __m256i *)(src + k*4));
+		_mm256_storeu_si256((__m256i *)(dst + k*4), _mm256_shuffle_epi8(v, mask));
+	}
+	ino_swap32_ssse3(dst + k*4, src + k*4, count - k);
+}
+
+__attribute__((target("avx2"))) static void
+ino_swap64_avx2(uint8_t *dst, const uint8_t *src, int count)
+{
+	const __m256i mask = _mm256_setr_epi8(7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8,
+	                                      7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8);
+	__m256i v;
+	int k;
+	
+	for(k=0; k+4<=count; k+=4)
+	{
+		v = _mm256_loadu_si256((const __m256i *)(src + k*8));
+		_mm256_storeu_si256((__m256i *)(dst + k*8), _mm256_shuffle_epi8(v, mask));
+	}
+	ino_swap64_ssse3(dst + k*8, src + k*8, count - k);
+}
+#endif
+
+#if defined(INO_SWAP_NEON)
+static void
+ino_swap16_neon(uint8_t *dst, const uint8_t *src, int count)
+{
+	int k;
+	
+	for(k=0; k+8<=count; k+=8)
+		vst1q_u8(dst + k*2, vrev16q_u8(vld1q_u8(src + k*2)));
+	ino_swap16_scalar(dst + k*2, src + k*2, count - k);
+}
+
+static void
+ino_swap32_neon(uint8_t *dst, const uint8_t *src, int count)
+{
+	int k;
+	
+	for(k=0; k+4<=count; k+=4)
+		vst1q_u8(dst + k*4, vrev32q_u8(vld1q_u8(src + k*4)));
+	ino_swap32_scalar(dst + k*4, src + k*4, count - k);
+}
+
+static void
+ino_swap64_neon(uint8_t *dst, const uint8_t *src, int count)
+{
+	int k;
+	
+	for(k=0; k+2<=count; k+=2)
+		vst1q_u8(dst + k*8, vrev64q_u8(vld1q_u8(src + k*8)));
+	ino_swap64_scalar(dst + k*8, src + k*8, count - k);
+}
+#endif
+
+static ino_swap_fn ino_swap16 = ino_swap16_scalar;
+static ino_swap_fn ino_swap32 = ino_swap32_scalar;
+static ino_swap_fn ino_swap64 = ino_swap64_scalar;
+static pthread_once_t ino_swap_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Pick the byte swap kernels for this CPU.
+ * Runs once per process through pthread_once().
+ * @since 0.2
+ */
+static void
+ino_swap_init(void)
+{
+#if defined(INO_SWAP_X86)
+	__builtin_cpu_init();
+	if ( __builtin_cpu_supports("avx2") )
+	{
+		ino_swap16 = ino_swap16_avx2;
+		ino_swap32 = ino_swap32_avx2;
+		ino_swap64 = ino_swap64_avx2;
+	}
+	else if ( __builtin_cpu_supports("ssse3") )
+	{
+		ino_swap16 = ino_swap16_ssse3;
+		ino_swap32 = ino_swap32_ssse3;
+		ino_swap64 = ino_swap64_ssse3;
+	}
+#elif defined(INO_SWAP_NEON)
+	ino_swap16 = ino_swap16_neon;
+	ino_swap32 = ino_swap32_neon;
+	ino_swap64 = ino_swap64_neon;
+#endif
+}
+
+/**
+ * Convert an array of big endian 16-bit integers into host byte order.
+ * @param dst Destination array of count uint16_t, may be the same memory as src.
+ * @param src Source bytes, 2 per integer, in network byte order.
+ * @param count The number of integers to convert.
+ * @since 0.2
+ */
+void
+ino_betoh16s(uint16_t *dst, const uint8_t *src, int count)
+{
+	if ( count <= 0 ) return;
+#if INO_HOST_BIG_ENDIAN
+	memmove(dst, src, count * 2);
+#else
+	pthread_once(&ino_swap_once, ino_swap_init);
+	ino_swap16((uint8_t *)dst, src, count);
+#endif
+}
+
+/**
+ * Convert an array of big endian 32-bit integers into host byte order.
+ * @param dst Destination array of count uint32_t, may be the same memory as src.
+ * @param src Source bytes, 4 per integer, in network byte order.
+ * @param count The number of integers to convert.
+ * @since 0.2
+ */
+void
+ino_betoh32s(uint32_t *dst, const uint8_t *src, int count)
+{
+	if ( count <= 0 ) return;
+#if INO_HOST_BIG_ENDIAN
+	memmove(dst, src, count * 4);
+#else
+	pthread_once(&ino_swap_once, ino_swap_init);
+	ino_swap32((uint8_t *)dst, src, count);
+#endif
+}
+
+/**
+ * Convert an array of big endian 64-bit integers into host byte order.
+ * @param dst Destination array of count uint64_t, may be the same memory as src.
+ * @param src Source bytes, 8 per integer, in network byte order.
+ * @param count The number of integers to convert.
+ * @since 0.2
+ */
+void
+ino_betoh64s(uint64_t *dst, const uint8_t *src, int count)
+{
+	if ( count <= 0 ) return;
+#if INO_HOST_BIG_ENDIAN
+	memmove(dst, src, count * 8);
+#else
+	pthread_once(&ino_swap_once, ino_swap_init);
+	ino_swap64((uint8_t *)dst, src, count);
+#endif
+}
+
+/**
+ * Convert an array of host 16-bit integers into big endian bytes.
+ * @param dst Destination bytes, 2 per integer, may be the same memory as src.
+ * @param src Source array of count uint16_t in host byte order.
+ * @param count The number of integers to convert.
+ * @since 0.2
+ */
+void
+ino_htobe16s(uint8_t *dst, const uint16_t *src, int count)
+{
+	if ( count <= 0 ) return;
+#if INO_HOST_BIG_ENDIAN
+	memmove(dst, src, count * 2);
+#else
+	pthread_once(&ino_swap_once, ino_swap_init);
+	ino_swap16(dst, (const uint8_t *)src, count);
+#endif
+}
+
+/**
+ * Convert an array of host 32-bit integers into big endian bytes.
+ * @param dst Destination bytes, 4 per integer, may be the same memory as src.
+ * @param src Source array of count uint32_t in host byte order.
+ * @param count The number of integers to convert.
+ * @since 0.2
+ */
+void
+ino_htobe32s(uint8_t *dst, const uint32_t *src, int count)
+{
+	if ( count <= 0 ) return;
+#if INO_HOST_BIG_ENDIAN
+	memmove(dst, src, count * 4);
+#else
+	pthread_once(&ino_swap_once, ino_swap_init);
+	ino_swap32(dst, (const uint8_t *)src, count);
+#endif
+}
+
+/**
+ * Convert an array of host 64-bit integers into big endian bytes.
+ * @param dst Destination bytes, 8 per integer, may be the same memory as src.
+ * @param src Source array of count uint64_t in host byte order.
+ * @param count The number of integers to convert.
+ * @since 0.2
+ */
+void
+ino_htobe64s(uint8_t *dst, const uint64_t *src, int count)
+{
+	if ( count <= 0 ) return;
+#if INO_HOST_BIG_ENDIAN
+	memmove(dst, src, count * 8);
+#else
+	pthread_once(&ino_swap_once, ino_swap_init);
+	ino_swap64(dst, (const uint8_t *)src, count);
+#endif
+}
+
+#ifdef __linux__
+static int ino_uring_stage(ino_connection_t *cnx, const uint8_t *buf, int nbytes);
+#endif
+
+/**
+ * Write a set of buffers to the port in full.
+ * Uses one writev() for all of them when the port accepts everything at
+ * once, and waits for the port to drain if it is in non-blocking mode.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @param iov Buffers to write; modified as bytes go out.
+ * @param iovcnt Number of buffers.
+ * @return The number of bytes written, or -1 on error before any were.
+ * @since 0.2
+ */
+static int
+ino_writev_all(ino_connection_t *cnx, struct iovec *iov, int iovcnt)
+{
+	int total = 0;			/* bytes written so far */
+	ssize_t n;
+	struct pollfd pfd;
+	
+	while ( iovcnt > 0 )
+	{
+		n = writev(cnx->fd, iov, iovcnt);
+		if ( n < 0 )
+		{
+			if ( errno == EINTR ) continue;
+			if ( errno == EAGAIN || errno == EWOULDBLOCK )
+			{
+				/* non-blocking port is full, wait for room */
+				pfd.fd = cnx->fd;
+				pfd.events = POLLOUT;
+				if ( poll(&pfd, 1, -1) >= 0 || errno == EINTR ) continue;
+			}
+			return total > 0 ? total : -1;
+		}
+		total += n;
+		/* skip the buffers written and advance into a partly written one */
+		while ( iovcnt > 0 && (size_t)n >= iov->iov_len )
+		{
+			n -= iov->iov_len;
+			iov++;
+			iovcnt--;
+		}
+		if ( iovcnt > 0 )
+		{
+			iov->iov_base = (uint8_t *)iov->iov_base + n;
+			iov->iov_len -= n;
+		}
+	}
+	
+	return total;
+}
+
+/**
+ * Drop bytes that went out from the front of the transmit buffer.
+ * @param cnx Pointer to ino_connection_t object.
+ * @param nbytes Number of held bytes written, at most out_len.
+ * @since 0.2
+ */
+static void
+ino_unhold(ino_connection_t *cnx, int nbytes)
+{
+	memmove(cnx->out_buf, cnx->out_buf + nbytes, cnx->out_len - nbytes);
+	cnx->out_len -= nbytes;
+}
+
+/**
+ * Write bytes to the port, hold them while corked, or queue them on io_uring.
+ * Corked output is appended to the transmit buffer unless that would fill it,
+ * reach the flush threshold, or the flush deadline has passed, in which case
+ * the held bytes and the new ones go out together in one writev().  Held
+ * bytes a failed write left behind stay in the transmit buffer.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @param buf Bytes to send.
+ * @param nbytes Number of bytes to send.
+ * @return The number of new bytes sent or queued, or -1 on error with none.
+ * @since 0.2
+ */
+static int
+ino_write(ino_connection_t *cnx, const uint8_t *buf, int nbytes)
+{
+	struct iovec iov[2];
+	struct timespec deadline, left;
+	int expired = 0;
+	int held;			/* bytes held before this call */
+	int n;
+	
+#ifdef __linux__
+	if ( cnx->uring ) return ino_uring_stage(cnx, buf, nbytes);
+#endif
+	
+	if ( cnx->corked )
+	{
+		if ( cnx->flush_delay > 0 && cnx->out_len > 0 )
+		{
+			/* deadline of the oldest waiting byte */
+			deadline = cnx->out_since;
+			deadline.tv_sec += cnx->flush_delay / 1000000;
+			deadline.tv_nsec += ( cnx->flush_delay % 1000000 ) * 1000;
+			if ( deadline.tv_nsec >= 1000000000 )
+			{
+				deadline.tv_sec++;
+				deadline.tv_nsec -= 1000000000;
+			}
+			expired = !ino_time_left(&deadline, &left);
+		}
+		if ( !expired && cnx->out_len + nbytes <= cnx->out_size
+			&& ( cnx->flush_threshold <= 0 || cnx->out_len + nbytes < cnx->flush_threshold ) )
+		{
+			/* hold on to it */
+			if ( cnx->out_len == 0 && cnx->flush_delay > 0 ) clock_gettime(CLOCK_MONOTONIC, &cnx->out_since);
+			memcpy(cnx->out_buf + cnx->out_len, buf, nbytes);
+			cnx->out_len += nbytes;
+			return nbytes;
+		}
+	}
+	
+	/* send what was held together with the new bytes */
+	iov[0].iov_base = cnx->out_buf;
+	iov[0].iov_len = cnx->out_len;
+	iov[1].iov_base = (void *)buf;
+	iov[1].iov_len = nbytes;
+	if ( cnx->out_len > 0 )
+	{
+		held = cnx->out_len;
+		n = ino_writev_all(cnx, iov, 2);
+		if ( n < held )
+		{
+			/* keep the held bytes that did not go out for the next flush */
+			ino_unhold(cnx, n > 0 ? n : 0);
+			return -1;
+		}
+		cnx->out_len = 0;
+		return n - held;
+	}
+	
+	return ino_writev_all(cnx, iov + 1, 1);
+}
+
+/**
+ * Send an array of raw bytes to the Arduino through the serial port.
+ * Sends an array of uint8_t through the given ino_connection_t/serial port.
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param buf Array of uint8_t bytes to send to the Arduino.
+ * @param frame_size_bytes The number of bytes to be sent to the Arduino.
+ * @return The number of bytes actually sent, or -1 on error.
+ * @since 0.1
+ */
+int
+ino_send_raw(ino_connection_t *cnx, uint8_t *buf, int frame_size_bytes)
+{
+	int n = 0;
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 )
+	{
+		n = ino_write(cnx, buf, frame_size_bytes);
+	}
+	
+	return n;
+}
+
+/**
+ * Send a single signed 16-bit integer to the Arduino through the serial port.
+ * Converts an int16_t to network byte order and sends it byte by byte through
+ * the given serial port connection to the Arduino on the other end.  Network
+ * byte order raw integers can be read by the Arduino using the corresponding
+ * "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param val int16_t to be sent to Arduino.
+ * @return The number of bytes actually sent, or -1 on error.
+ * @since 0.1
+ */
+int
+ino_send_int16(ino_connection_t *cnx, int16_t val)
+{
+	int n = 0;
+	uint8_t buf[2];
+	ino_int16 i;
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 )
+	{
+		i.sig = val;
+		buf[0] = (i.unsig >> 8) & 0xFF;
+		buf[1] = i.unsig & 0xFF;
+		n = ino_write(cnx, buf, 2);
+	}
+	
+	return n;
+}
+
+/**
+ * Send a single unsigned 16-bit integer to the Arduino through the serial port.
+ * Converts an uint16_t to network byte order and sends it byte by byte through
+ * the given serial port connection to the Arduino on the other end.  Network
+ * byte order raw integers can be read by the Arduino using the corresponding
+ * "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param val uint16_t to be sent to Arduino.
+ * @return The number of bytes actually sent, or -1 on error.
+ * @since 0.1
+ */
+int
+ino_send_uint16(ino_connection_t *cnx, uint16_t val)
+{
+	int n = 0;
+	uint8_t buf[2];
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 )
+	{
+		buf[0] = (val >> 8) & 0xFF;
+		buf[1] = val & 0xFF;
+		n = ino_write(cnx, buf, 2);
+	}
+	
+	return n;
+}
+
+/**
+ * Send a single signed 32-bit integer to the Arduino through the serial port.
+ * Converts an int32_t to network byte order and sends it byte by byte through
+ * the given serial port connection to the Arduino on the other end.  Network
+ * byte order raw integers can be read by the Arduino using the corresponding
+ * "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param val int32_t to be sent to Arduino.
+ * @return The number of bytes actually sent, or -1 on error.
+ * @since 0.1
+ */
+int
+ino_send_int32(ino_connection_t *cnx, int32_t val)
+{
+	int n = 0;
+	uint8_t buf[4];
+	ino_int32 i;
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 )
+	{
+		i.sig = val;
+		buf[0] = (i.unsig >> 24) & 0xFF;
+		buf[1] = (i.unsig >> 16) & 0xFF;
+		buf[2] = (i.unsig >> 8) & 0xFF;
+		buf[3] = i.unsig & 0xFF;
+		n = ino_write(cnx, buf, 4);
+	}
+		
+	return n;
+}
+
+/**
+ * Send a single unsigned 32-bit integer to the Arduino through the serial port.
+ * Converts a uint32_t to network byte order and sends it byte by byte through
+ * the given serial port connection to the Arduino on the other end.  Network
+ * byte order raw integers can be read by the Arduino using the corresponding
+ * "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param val uint32_t to be sent to Arduino.
+ * @return The number of bytes actually sent, or -1 on error.
+ * @since 0.1
+ */
+int
+ino_send_uint32(ino_connection_t *cnx, uint32_t val)
+{
+	int n = 0;
+	uint8_t buf[4];
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 )
+	{
+		buf[0] = (val >> 24) & 0xFF;
+		buf[1] = (val >> 16) & 0xFF;
+		buf[2] = (val >> 8) & 0xFF;
+		buf[3] = val & 0xFF;
+		n = ino_write(cnx, buf, 4);
+	}
+		
+	return n;
+}
+
+/**
+ * Send multiple signed 16-bit integers to the Arduino at once.
+ * Converts each int16_t to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 2 bytes per integer.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param int_buf Pointer to the beginning of an array of int16_t.
+ * @param int_count The number of integers to send.
+ * @return The number of integers sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_send_int16s(ino_connection_t *cnx, const int16_t *int_buf, int int_count)
+{
+	int n = -1;														/* return integers sent or -1 on error */
+	int frame_size = ( int_count >= 0 && int_count <= INT_MAX / 2 ) ? int_count * 2 : -1;				/* number of bytes in frame, -1 if too many */
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && frame_size >= 0 && ino_reserve_scratch(cnx, frame_size) == 0 )
+	{
+		/* put every integer into the frame in network byte order */
+		ino_htobe16s(cnx->scratch, (const uint16_t *)int_buf, int_count);
+		/* send the whole frame at once */
+		n = ino_write(cnx, cnx->scratch, frame_size);
+		if ( n != -1 ) n = int_count;
+	}
+	
+	return n;
+}
+
+/**
+ * Send multiple unsigned 16-bit integers to the Arduino at once.
+ * Converts each uint16_t to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 2 bytes per integer.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param int_buf Pointer to the beginning of an array of uint16_t.
+ * @param int_count The number of integers to send.
+ * @return The number of integers sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_send_uint16s(ino_connection_t *cnx, const uint16_t *int_buf, int int_count)
+{
+	int n = -1;														/* return integers sent or -1 on error */
+	int frame_size = ( int_count >= 0 && int_count <= INT_MAX / 2 ) ? int_count * 2 : -1;				/* number of bytes in frame, -1 if too many */
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && frame_size >= 0 && ino_reserve_scratch(cnx, frame_size) == 0 )
+	{
+		/* put every integer into the frame in network byte order */
+		ino_htobe16s(cnx->scratch, (const uint16_t *)int_buf, int_count);
+		/* send the whole frame at once */
+		n = ino_write(cnx, cnx->scratch, frame_size);
+		if ( n != -1 ) n = int_count;
+	}
+	
+	return n;
+}
+
+/**
+ * Send multiple signed 32-bit integers to the Arduino at once.
+ * Converts each int32_t to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 4 bytes per integer.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param int_buf Pointer to the beginning of an array of int32_t.
+ * @param int_count The number of integers to send.
+ * @return The number of integers sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_send_int32s(ino_connection_t *cnx, const int32_t *int_buf, int int_count)
+{
+	int n = -1;														/* return integers sent or -1 on error */
+	int frame_size = ( int_count >= 0 && int_count <= INT_MAX / 4 ) ? int_count * 4 : -1;				/* number of bytes in frame, -1 if too many */
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && frame_size >= 0 && ino_reserve_scratch(cnx, frame_size) == 0 )
+	{
+		/* put every integer into the frame in network byte order */
+		ino_htobe32s(cnx->scratch, (const uint32_t *)int_buf, int_count);
+		/* send the whole frame at once */
+		n = ino_write(cnx, cnx->scratch, frame_size);
+		if ( n != -1 ) n = int_count;
+	}
+	
+	return n;
+}
+
+/**
+ * Send multiple unsigned 32-bit integers to the Arduino at once.
+ * Converts each uint32_t to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 4 bytes per integer.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param int_buf Pointer to the beginning of an array of uint32_t.
+ * @param int_count The number of integers to send.
+ * @return The number of integers sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_send_uint32s(ino_connection_t *cnx, const uint32_t *int_buf, int int_count)
+{
+	int n = -1;														/* return integers sent or -1 on error */
+	int frame_size = ( int_count >= 0 && int_count <= INT_MAX / 4 ) ? int_count * 4 : -1;				/* number of bytes in frame, -1 if too many */
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && frame_size >= 0 && ino_reserve_scratch(cnx, frame_size) == 0 )
+	{
+		/* put every integer into the frame in network byte order */
+		ino_htobe32s(cnx->scratch, (const uint32_t *)int_buf, int_count);
+		/* send the whole frame at once */
+		n = ino_write(cnx, cnx->scratch, frame_size);
+		if ( n != -1 ) n = int_count;
+	}
+	
+	return n;
+}
+
+/**
+ * Send a single signed 64-bit integer to the Arduino through the serial port.
+ * Converts an int64_t to network byte order and sends it byte by byte through
+ * the given serial port connection to the Arduino on the other end.  Network
+ * byte order raw integers can be read by the Arduino using the corresponding
+ * "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param val int64_t to be sent to Arduino.
+ * @return The number of bytes actually sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_send_int64(ino_connection_t *cnx, int64_t val)
+{
+	int n = 0;
+	int j;
+	uint8_t buf[8];
+	ino_int64 i;
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 )
+	{
+		i.sig = val;
+		for(j=0; j<8; j++)
+			buf[j] = ( i.unsig >> ( 56 - j*8 ) ) & 0xFF;
+		n = ino_write(cnx, buf, 8);
+	}
+		
+	return n;
+}
+
+/**
+ * Send a single unsigned 64-bit integer to the Arduino through the serial port.
+ * Converts a uint64_t to network byte order and sends it byte by byte through
+ * the given serial port connection to the Arduino on the other end.  Network
+ * byte order raw integers can be read by the Arduino using the corresponding
+ * "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param val uint64_t to be sent to Arduino.
+ * @return The number of bytes actually sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_send_uint64(ino_connection_t *cnx, uint64_t val)
+{
+	int n = 0;
+	int j;
+	uint8_t buf[8];
+	ino_int64 i;
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 )
+	{
+		i.unsig = val;
+		for(j=0; j<8; j++)
+			buf[j] = ( i.unsig >> ( 56 - j*8 ) ) & 0xFF;
+		n = ino_write(cnx, buf, 8);
+	}
+		
+	return n;
+}
+
+/**
+ * Send a single IEEE-754 single precision float to the Arduino through the serial port.
+ * Sends the 4 byte binary32 encoding of the value in network byte order,
+ * which the Arduino can read with the corresponding "read" function in the
+ * Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param val float to be sent to Arduino.
+ * @return The number of bytes actually sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_send_float(ino_connection_t *cnx, float val)
+{
+	ino_float32 tmp;		/* value to bits converter */
+	
+	tmp.val = val;
+	
+	return ino_send_uint32(cnx, tmp.bits);
+}
+
+/**
+ * Send a single IEEE-754 double precision float to the Arduino through the serial port.
+ * Sends the 8 byte binary64 encoding of the value in network byte order,
+ * which the Arduino can read with the corresponding "read" function in the
+ * Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param val double to be sent to Arduino.
+ * @return The number of bytes actually sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_send_double(ino_connection_t *cnx, double val)
+{
+	ino_float64 tmp;		/* value to bits converter */
+	
+	tmp.val = val;
+	
+	return ino_send_uint64(cnx, tmp.bits);
+}
+
+/**
+ * Send multiple signed 64-bit integers to the Arduino at once.
+ * Converts each value to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 8 bytes per value.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param int_buf Pointer to the beginning of an array of int64_t.
+ * @param int_count The number of values to send.
+ * @return The number of values sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_send_int64s(ino_connection_t *cnx, const int64_t *int_buf, int int_count)
+{
+	int n = -1;														/* return values sent or -1 on error */
+	int frame_size = ( int_count >= 0 && int_count <= INT_MAX / 8 ) ? int_count * 8 : -1;				/* number of bytes in frame, -1 if too many */
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && frame_size >= 0 && ino_reserve_scratch(cnx, frame_size) == 0 )
+	{
+		/* put every value into the frame in network byte order */
+		ino_htobe64s(cnx->scratch, (const uint64_t *)int_buf, int_count);
+		/* send the whole frame at once */
+		n = ino_write(cnx, cnx->scratch, frame_size);
+		if ( n != -1 ) n = int_count;
+	}
+	
+	return n;
+}
+
+/**
+ * Send multiple unsigned 64-bit integers to the Arduino at once.
+ * Converts each value to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 8 bytes per value.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param int_buf Pointer to the beginning of an array of uint64_t.
+ * @param int_count The number of values to send.
+ * @return The number of values sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_send_uint64s(ino_connection_t *cnx, const uint64_t *int_buf, int int_count)
+{
+	int n = -1;														/* return values sent or -1 on error */
+	int frame_size = ( int_count >= 0 && int_count <= INT_MAX / 8 ) ? int_count * 8 : -1;				/* number of bytes in frame, -1 if too many */
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && frame_size >= 0 && ino_reserve_scratch(cnx, frame_size) == 0 )
+	{
+		/* put every value into the frame in network byte order */
+		ino_htobe64s(cnx->scratch, (const uint64_t *)int_buf, int_count);
+		/* send the whole frame at once */
+		n = ino_write(cnx, cnx->scratch, frame_size);
+		if ( n != -1 ) n = int_count;
+	}
+	
+	return n;
+}
+
+/**
+ * Send multiple IEEE-754 single precision floats to the Arduino at once.
+ * Converts each value to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 4 bytes per value.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param buf Pointer to the beginning of an array of float.
+ * @param count The number of values to send.
+ * @return The number of values sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_send_floats(ino_connection_t *cnx, const float *buf, int count)
+{
+	int n = -1;														/* return values sent or -1 on error */
+	int frame_size = ( count >= 0 && count <= INT_MAX / 4 ) ? count * 4 : -1;				/* number of bytes in frame, -1 if too many */
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && frame_size >= 0 && ino_reserve_scratch(cnx, frame_size) == 0 )
+	{
+		/* put every value into the frame in network byte order */
+		ino_htobe32s(cnx->scratch, (const uint32_t *)buf, count);
+		/* send the whole frame at once */
+		n = ino_write(cnx, cnx->scratch, frame_size);
+		if ( n != -1 ) n = count;
+	}
+	
+	return n;
+}
+
+/**
+ * Send multiple IEEE-754 double precision floats to the Arduino at once.
+ * Converts each value to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 8 bytes per value.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param buf Pointer to the beginning of an array of double.
+ * @param count The number of values to send.
+ * @return The number of values sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_send_doubles(ino_connection_t *cnx, const double *buf, int count)
+{
+	int n = -1;														/* return values sent or -1 on error */
+	int frame_size = ( count >= 0 && count <= INT_MAX / 8 ) ? count * 8 : -1;				/* number of bytes in frame, -1 if too many */
+	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 && frame_size >= 0 && ino_reserve_scratch(cnx, frame_size) == 0 )
+	{
+		/* put every value into the frame in network byte order */
+		ino_htobe64s(cnx->scratch, (const uint64_t *)buf, count);
+		/* send the whole frame at once */
+		n = ino_write(cnx, cnx->scratch, frame_size);
+		if ( n != -1 ) n = count;
+	}
+	
+	return n;
+}
+
+/**
+ * Send a single char through the serial port.
+ * Sends a single character through the serial port to the Arduino.
+ * @param c The character to send to the Arduino.
+ * @return 1 on success, or -1 on failure.
+ * @since 0.1
+ */
+int ino_send_char(ino_connection_t *cnx, char c)
+{
+ 	int n = -1;
+ 	
+	/* if connected */	
+	if ( cnx && cnx->fd > -1 )
+	{
+		n = ino_write(cnx, (uint8_t *)&c, 1);
+		if ( n < 1 ) n = -1;
+	}
+	
+	return n;
+}
+
+/*
+ * Checksums.  CRC-16/CCITT is cheap enough for the Arduino to compute with a
+ * 256 entry table and protects the frames of ino_send_frame().  CRC32C is for
+ * checking large raw transfers on the computer; it runs on the SSE4.2 or ARMv8
+ * crc32c instructions when the CPU has them, picked once per process, and on a
+ * table otherwise.  Both can be updated piece by piece as bytes arrive.
+ */
+static const uint16_t ino_crc16_table[256] =
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+/**
+ * Update a CRC-16/CCITT checksum with more bytes.
+ * @param crc INO_CRC16_INIT for the first bytes, or the previous return value.
+ * @param buf Next bytes.
+ * @param nbytes Number of bytes in buf.
+ * @return CRC of all bytes so far.
+ * @since 0.2
+ */
+uint16_t
+ino_crc16(uint16_t crc, const uint8_t *buf, int nbytes)
+{
+	int i;
+	
+	for(i=0; i<nbytes; i++)
+		crc = (uint16_t)( ( crc << 8 ) ^ ino_crc16_table[( crc >> 8 ) ^ buf[i]] );
+	
+	return crc;
+}
+
+typedef uint32_t (*ino_crc32c_fn)(uint32_t crc, const uint8_t *buf, int nbytes);
+
+static uint32_t ino_crc32c_table[256];
+
+static uint32_t
+ino_crc32c_scalar(uint32_t crc, const uint8_t *buf, int nbytes)
+{
+	int i;
+	
+	for(i=0; i<nbytes; i++)
+		crc = ( crc >> 8 ) ^ ino_crc32c_table[( crc ^ buf[i] ) & 0xFF];
+	
+	return crc;
+}
+
+#if defined(INO_CRC_X86)
+__attribute__((target("sse4.2"))) static uint32_t
+ino_crc32c_sse42(uint32_t crc, const uint8_t *buf, int nbytes)
+{
+	int k = 0;
+#if defined(__x86_64__)
+	uint64_t v;
+	uint64_t c = crc;
+	
+	for(; k+8<=nbytes; k+=8)
+	{
+		memcpy(&v, buf + k, 8);
+		c = _mm_crc32_u64(c, v);
+	}
+	crc = (uint32_t)c;
+#else
+	uint32_t v;
+	
+	for(; k+4<=nbytes; k+=4)
+	{
+		memcpy(&v, buf + k, 4);
+		crc = _mm_crc32_u32(crc, v);
+	}
+#endif
+	for(; k<nbytes; k++)
+		crc = _mm_crc32_u8(crc, buf[k]);
+	
+	return crc;
+}
+#endif
+
+#if defined(INO_CRC_ARM)
+__attribute__((target("+crc"))) static uint32_t
+ino_crc32c_armv8(uint32_t crc, const uint8_t *buf, int nbytes)
+{
+	uint64_t v;
+	int k;
+	
+	for(k=0; k+8<=nbytes; k+=8)
+	{
+		memcpy(&v, buf + k, 8);
+		crc = __crc32cd(crc, v);
+	}
+	for(; k<nbytes; k++)
+		crc = __crc32cb(crc, buf[k]);
+	
+	return crc;
+}
+#endif
+
+static ino_crc32c_fn ino_crc32c_update = ino_crc32c_scalar;
+static pthread_once_t ino_crc32c_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Build the CRC32C table and pick the CRC32C kernel for this CPU.
+ * Runs once per process through pthread_once().
+ * @since 0.2
+ */
+static void
+ino_crc32c_init(void)
+{
+	uint32_t c;
+	int i, j;
+	
+	for(i=0; i<256; i++)
+	{
+		c = i;
+		for(j=0; j<8; j++)
+			c = ( c & 1 ) ? ( c >> 1 ) ^ 0x82F63B78 : c >> 1;
+		ino_crc32c_table[i] = c;
+	}
+#if defined(INO_CRC_X86)
+	__builtin_cpu_init();
+	if ( __builtin_cpu_supports("sse4.2") ) ino_crc32c_update = ino_crc32c_sse42;
+#elif defined(INO_CRC_ARM)
+	if ( getauxval(AT_HWCAP) & HWCAP_CRC32 ) ino_crc32c_update = ino_crc32c_armv8;
+#endif
+}
+
+/**
+ * Update a CRC32C (Castagnoli) checksum with more bytes.
+ * @param crc INO_CRC32C_INIT for the first bytes, or the previous return value.
+ * @param buf Next bytes.
+ * @param nbytes Number of bytes in buf.
+ * @return CRC of all bytes so far.
+ * @since 0.2
+ */
+uint32_t
+ino_crc32c(uint32_t crc, const uint8_t *buf, int nbytes)
+{
+	if ( nbytes <= 0 ) return crc;
+	pthread_once(&ino_crc32c_once, ino_crc32c_init);
+	
+	return ~ino_crc32c_update(~crc, buf, nbytes);
+}
+
+/**
+ * SLIP-escape bytes into a buffer.
+ * @param dst Destination with room for twice nbytes.
+ * @param src Bytes to escape.
+ * @param nbytes Number of bytes in src.
+ * @return Number of bytes written to dst.
+ * @since 0.2
+ */
+static int
+ino_frame_escape(uint8_t *dst, const uint8_t *src, int nbytes)
+{
+	int i, k = 0;
+	
+	for(i=0; i<nbytes; i++)
+	{
+		if ( src[i] == INO_FRAME_END )
+		{
+			dst[k++] = INO_FRAME_ESC;
+			dst[k++] = INO_FRAME_ESC_END;
+		}
+		else if ( src[i] == INO_FRAME_ESC )
+		{
+			dst[k++] = INO_FRAME_ESC;
+			dst[k++] = INO_FRAME_ESC_ESC;
+		}
+		else
+			dst[k++] = src[i];
+	}
+	
+	return k;
+}
+
+/**
+ * Send a frame of bytes to the Arduino with framing and a checksum.
+ * The frame goes out as an end byte, the SLIP-escaped 16-bit length, payload
+ * and CRC-16/CCITT of both in network byte order, and another end byte, all in
+ * a single write.  The Arduino can read it with ino_read_frame() in the Arduino
+ * library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param buf Payload to send.
+ * @param nbytes Number of payload bytes, 1 to INO_MAX_FRAME_SIZE.
+ * @return The number of payload bytes sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_send_frame(ino_connection_t *cnx, const uint8_t *buf, int nbytes)
+{
+	int n = -1;									/* return bytes sent or -1 on error */
+	int k = 0;									/* bytes in the encoded frame */
+	uint8_t field[2];						/* length or CRC in network byte order */
+	uint16_t crc;
+	
+	/* if connected */
+	if ( cnx && cnx->fd > -1 && nbytes > 0 && nbytes <= INO_MAX_FRAME_SIZE
+		&& ino_reserve_scratch(cnx, 2 * ( nbytes + 4 ) + 2) == 0 )
+	{
+		cnx->scratch[k++] = INO_FRAME_END;
+		field[0] = (uint8_t)( nbytes >> 8 );
+		field[1] = (uint8_t)nbytes;
+		crc = ino_crc16(INO_CRC16_INIT, field, 2);
+		k += ino_frame_escape(cnx->scratch + k, field, 2);
+		crc = ino_crc16(crc, buf, nbytes);
+		k += ino_frame_escape(cnx->scratch + k, buf, nbytes);
+		field[0] = (uint8_t)( crc >> 8 );
+		field[1] = (uint8_t)crc;
+		k += ino_frame_escape(cnx->scratch + k, field, 2);
+		cnx->scratch[k++] = INO_FRAME_END;
+		/* send the whole frame at once */
+		n = ino_write(cnx, cnx->scratch, k);
+		if ( n != -1 ) n = nbytes;
+	}
+	
+	return n;
+}
+
+/**
+ * Unescape and check a SLIP frame in place.
+ * @param buf Frame bytes between two end bytes, overwritten with the unescaped bytes.
+ * @param nbytes Number of bytes in buf.
+ * @return Payload size, with the payload starting at buf + 2, or -1 if the
+ *         frame has a bad escape, length or CRC.
+ * @since 0.2
+ */
+static int
+ino_frame_check(uint8_t *buf, int nbytes)
+{
+	int i, k;
+	uint8_t *esc;
+	int size;
+	
+	/* most frames carry no escapes, skip straight to the first */
+	esc = (uint8_t *)memchr(buf, INO_FRAME_ESC, nbytes);
+	k = esc ? esc - buf : nbytes;
+	for(i=k; i<nbytes; i++)
+	{
+		if ( buf[i] != INO_FRAME_ESC )
+			buf[k++] = buf[i];
+		else if ( ++i < nbytes && buf[i] == INO_FRAME_ESC_END )
+			buf[k++] = INO_FRAME_END;
+		else if ( i < nbytes && buf[i] == INO_FRAME_ESC_ESC )
+			buf[k++] = INO_FRAME_ESC;
+		else
+			return -1;
+	}
+	
+	if ( k < 4 ) return -1;
+	size = ( buf[0] << 8 ) | buf[1];
+	if ( size != k - 4 || ino_crc16(INO_CRC16_INIT, buf, k - 2) != ( ( buf[k - 2] << 8 ) | buf[k - 1] ) )
+		return -1;
+	
+	return size;
+}
+
+/**
+ * Read the next valid frame sent by ino_send_frame() in the Arduino library.
+ * Scans the input for end bytes and checks the length and CRC of every frame
+ * in between.  Damaged frames, noise, empty frames, which neither side
+ * sends, and frames larger than max_bytes are dropped and counted in
+ * frame_errors, and reading resumes at the next end byte, so a lost or
+ * corrupted byte costs one frame instead of the alignment of the whole
+ * stream.  The port must wake on every byte, see libuino.h.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param buf Destination for the payload.
+ * @param max_bytes Capacity of buf.
+ * @param timeout_us Microseconds to wait for a valid frame, or INO_NO_TIMEOUT.
+ * @return Payload size, 0 on timeout or hang up, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_read_frame(ino_connection_t *cnx, uint8_t *buf, int max_bytes, long timeout_us)
+{
+	int n = -1;									/* return payload size or -1 on error */
+	int len;										/* encoded frame length including its end byte */
+	struct timespec deadline;		/* when to give up */
+
+	/* frames are variable length, a port waiting for VMIN bytes could hold one back */
+	if ( cnx && !ino_reads_bytewise(cnx) )
+	{
+		errno = EINVAL;
+		return -1;
+	}
+	
+	/* if connected */
+	if ( cnx && cnx->fd > -1 && max_bytes > 0 && timeout_us >= 0 )
+	{
+		ino_release_view(cnx);
+		if ( timeout_us != INO_NO_TIMEOUT ) ino_deadline(&deadline, timeout_us);
+		do
+		{
+			len = ino_find_delim(cnx, INO_FRAME_END, timeout_us == INO_NO_TIMEOUT ? NULL : &deadline);
+			if ( len <= 0 ) return len;
+			
+			/* an end byte right after another one only marks a frame start */
+			n = len > 1 ? ino_frame_check(cnx->in_buf + cnx->in_head, len - 1) : 0;
+			if ( n > 0 && n <= max_bytes )
+				memcpy(buf, cnx->in_buf + cnx->in_head + 2, n);
+			else if ( len > 1 )
+			{
+				cnx->frame_errors++;
+				n = 0;
+			}
+			cnx->in_head += len;
+			if ( cnx->in_head == cnx->in_tail ) cnx->in_head = cnx->in_tail = 0;
+		}
+		while ( n == 0 );
+	}
+	
+	return n;
+}
+
+/**
+ * Body of a connection's background reader thread.
+ * Reads straight into the free slots of the frame queue, publishing each
+ * frame as soon as its last byte lands.  When the queue is full, incoming
+ * frames are read into the input buffer and discarded so the port keeps
+ * draining.
+ * @param arg Pointer to the ino_connection_t object being read.
+ * @return NULL.
+ * @since 0.2
+ */
+static void *
+ino_reader_run(void *arg)
+{
+	ino_connection_t *cnx = (ino_connection_t *)arg;
+	ino_reader_t *rd = cnx->reader;
+	struct pollfd pfd[2];			/* port and wake pipe */
+	size_t capacity = rd->mask + 1;
+	size_t slot;							/* slot of the frame in progress */
+	size_t free_frames;				/* empty slots, including the one in progress */
+	int nbytes;								/* bytes to request from the port */
+	int n;
+	
+	pfd[0].fd = cnx->fd;
+	pfd[0].events = POLLIN;
+	pfd[1].fd = rd->wake[0];
+	pfd[1].events = POLLIN;
+	
+	while ( 1 )
+	{
+		/* wait for data or shutdown */
+		n = poll(pfd, 2, -1);
+		if ( n < 0 && errno == EINTR ) continue;
+		if ( n < 0 || pfd[1].revents ) break;
+		
+		/* read until the port has nothing more to give */
+		do
+		{
+			free_frames = capacity - ( rd->tail - rd->head_cache );
+			if ( free_frames == 0 )
+			{
+				rd->head_cache = __atomic_load_n(&rd->head, __ATOMIC_ACQUIRE);
+				free_frames = capacity - ( rd->tail - rd->head_cache );
+			}
+			
+			/* queue full: discard the next frame so the port keeps draining */
+			if ( free_frames == 0 && rd->skip == 0 ) rd->skip = rd->frame_size;
+			if ( rd->skip > 0 )
+			{
+				nbytes = rd->skip < cnx->in_size ? rd->skip : cnx->in_size;
+				n = read(cnx->fd, cnx->in_buf, nbytes);
+				if ( n <= 0 ) continue;
+				rd->skip -= n;
+				if ( rd->skip == 0 )
+					__atomic_store_n(&rd->dropped, rd->dropped + 1, __ATOMIC_RELAXED);
+				continue;
+			}
+			
+			/* read into as many contiguous free slots as possible */
+			slot = rd->tail & rd->mask;
+			if ( free_frames > capacity - slot ) free_frames = capacity - slot;
+			nbytes = (int)( free_frames * rd->frame_size ) - rd->partial;
+			n = read(cnx->fd, rd->frames + slot * rd->frame_size + rd->partial, nbytes);
+			if ( n <= 0 ) continue;
+			
+			/* publish every frame completed by this read */
+			rd->partial += n;
+			if ( rd->partial >= rd->frame_size )
+			{
+				__atomic_store_n(&rd->tail, rd->tail + rd->partial / rd->frame_size, __ATOMIC_RELEASE);
+				rd->partial %= rd->frame_size;
+			}
+		}
+		while ( n > 0 || ( n < 0 && errno == EINTR ) );
+		
+		/* a read of zero bytes or a hard error means the port is gone */
+		if ( n == 0 || ( errno != EAGAIN && errno != EWOULDBLOCK ) ) break;
+	}
+	
+	__atomic_store_n(&rd->running, 0, __ATOMIC_RELEASE);
+	
+	return NULL;
+}
+
+/**
+ * Hold the output of ino_send_*() calls in the connection's transmit buffer.
+ * A command made of several fields then goes out in a single write(), and
+ * usually a single USB packet, when ino_flush() or ino_uncork() is called,
+ * when the buffer fills, or when ino_set_autoflush() limits are reached.
+ * Connections attached to an io_uring engine already batch their output, so
+ * corking has no further effect on them.
+ * @param cnx Pointer to ino_connection_t object to cork.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int
+ino_cork(ino_connection_t *cnx)
+{
+	if ( !cnx ) return -1;
+	
+	/* the transmit buffer is only allocated for connections that use it */
+	if ( !cnx->out_buf )
+	{
+		cnx->out_buf = (uint8_t *)malloc(INO_OUTPUT_BUFFER_SIZE);
+		if ( !cnx->out_buf ) return -1;
+		cnx->out_size = INO_OUTPUT_BUFFER_SIZE;
+	}
+	cnx->corked = 1;
+	
+	return 0;
+}
+
+/**
+ * Send all output held in the connection's transmit buffer.
+ * The connection stays corked.  Bytes a failed write left behind stay held.
+ * @param cnx Pointer to ino_connection_t object to flush.
+ * @return The number of bytes sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_flush(ino_connection_t *cnx)
+{
+	int n = -1;
+	struct iovec iov;
+	
+	/* if connected */
+	if ( cnx && cnx->fd > -1 )
+	{
+		n = 0;
+		if ( cnx->out_len > 0 )
+		{
+			iov.iov_base = cnx->out_buf;
+			iov.iov_len = cnx->out_len;
+#ifdef __linux__
+			if ( cnx->uring )
+				n = ino_uring_stage(cnx, cnx->out_buf, cnx->out_len);
+			else
+#endif
+				n = ino_writev_all(cnx, &iov, 1);
+			/* keep whatever did not go out */
+			if ( n > -1 && n < cnx->out_len )
+				ino_unhold(cnx, n);
+			else if ( n > -1 )
+				cnx->out_len = 0;
+		}
+	}
+	
+	return n;
+}
+
+/**
+ * Send all held output and stop holding the output of later sends.
+ * @param cnx Pointer to ino_connection_t object to uncork.
+ * @return The number of bytes sent, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_uncork(ino_connection_t *cnx)
+{
+	int n = -1;
+	
+	if ( cnx )
+	{
+		n = ino_flush(cnx);
+		cnx->corked = 0;
+	}
+	
+	return n;
+}
+
+/**
+ * Set when corked output is flushed without an explicit ino_flush().
+ * Output is flushed by the send that brings the waiting bytes to
+ * threshold_bytes, and by the first send made delay_us microseconds or more
+ * after the oldest waiting byte was corked.  Either limit may be zero to
+ * disable it.  The deadline is only checked when sending, so call
+ * ino_flush() before going idle.
+ * @param cnx Pointer to ino_connection_t object to configure.
+ * @param threshold_bytes Waiting bytes that trigger a flush, or 0.
+ * @param delay_us Microseconds output may wait before a send flushes it, or 0.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int
+ino_set_autoflush(ino_connection_t *cnx, int threshold_bytes, long delay_us)
+{
+	if ( !cnx || threshold_bytes < 0 || delay_us < 0 ) return -1;
+	
+	cnx->flush_threshold = threshold_bytes;
+	cnx->flush_delay = delay_us;
+	if ( cnx->out_len > 0 && delay_us > 0 ) clock_gettime(CLOCK_MONOTONIC, &cnx->out_since);
+	
+	return 0;
+}
+
+/**
+ * Start a background reader thread on an open raw connection.
+ * The thread reads raw_size byte frames from the port as fast as they arrive
+ * and publishes them into a lock-free queue holding at least nframes frames,
+ * from which the application takes them with ino_reader_pop() without any
+ * syscalls or locks.  A slow application therefore never stalls the port;
+ * if the queue fills up, new frames are dropped and counted in the reader's
+ * dropped field rather than left to overflow the kernel buffer.  While the
+ * reader runs, no other read function may be used on the connection.
+ * @param cnx Pointer to an open ino_connection_t object created with ino_connection_raw().
+ * @param nframes Minimum number of frames the queue should hold.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int
+ino_reader_start(ino_connection_t *cnx, int nframes)
+{
+	ino_reader_t *rd = NULL;
+	size_t capacity = 1;
+	void *mem = NULL;
+	
+	if ( !cnx || cnx->fd == -1 || !cnx->raw || cnx->raw_size <= 0 || cnx->reader || nframes <= 0 )
+		return -1;
+	
+	/* round the queue up to a power of two so slots wrap with a mask */
+	while ( capacity < (size_t)nframes ) capacity <<= 1;
+	
+	if ( posix_memalign(&mem, INO_CACHE_LINE, sizeof(ino_reader_t)) != 0 ) return -1;
+	rd = (ino_reader_t *)mem;
+	memset(rd, 0, sizeof(ino_reader_t));
+	rd->frames = (uint8_t *)malloc(capacity * cnx->raw_size);
+	rd->mask = capacity - 1;
+	rd->frame_size = cnx->raw_size;
+	rd->running = 1;
+	
+	if ( !rd->frames || pipe(rd->wake) == -1 )
+	{
+		free(rd->frames);
+		free(rd);
+		return -1;
+	}
+	
+	/* frames already buffered by earlier reads come first */
+	ino_release_view(cnx);
+	while ( cnx->in_tail - cnx->in_head >= rd->frame_size && rd->tail < capacity )
+	{
+		memcpy(rd->frames + rd->tail * rd->frame_size, cnx->in_buf + cnx->in_head, rd->frame_size);
+		cnx->in_head += rd->frame_size;
+		rd->tail++;
+	}
+	if ( rd->tail < capacity )
+	{
+		rd->partial = cnx->in_tail - cnx->in_head;
+		memcpy(rd->frames + rd->tail * rd->frame_size, cnx->in_buf + cnx->in_head, rd->partial);
+	}
+	else
+	{
+		/* more than the queue can hold: drop the excess, finishing any partial frame */
+		rd->dropped = ( cnx->in_tail - cnx->in_head ) / rd->frame_size;
+		rd->skip = ( cnx->in_tail - cnx->in_head ) % rd->frame_size;
+		if ( rd->skip > 0 ) rd->skip = rd->frame_size - rd->skip;
+	}
+	cnx->in_head = cnx->in_tail = 0;
+	
+	cnx->reader = rd;
+	if ( ino_set_nonblock(cnx, 1) == -1 || pthread_create(&rd->thread, NULL, ino_reader_run, cnx) != 0 )
+	{
+		cnx->reader = NULL;
+		close(rd->wake[0]);
+		close(rd->wake[1]);
+		free(rd->frames);
+		free(rd);
+		return -1;
+	}
+	
+	return 0;
+}
+
+/**
+ * Take the oldest frame from a connection's background reader queue.
+ * Never blocks and makes no syscalls.
+ * @param cnx Pointer to ino_connection_t object with a running reader.
+ * @param buf Pointer to an array of at least raw_size uint8_t.
+ * @return raw_size if a frame was copied, 0 if the queue is empty, or -1
+ * if the queue is empty and the reader has stopped after a hang up or error.
+ * @since 0.2
+ */
+int
+ino_reader_pop(ino_connection_t *cnx, uint8_t *buf)
+{
+	ino_reader_t *rd;
+	
+	if ( !cnx || !cnx->reader ) return -1;
+	rd = cnx->reader;
+	
+	/* only look at the producer's cache line when the cached tail runs out */
+	if ( rd->head == rd->tail_cache )
+	{
+		rd->tail_cache = __atomic_load_n(&rd->tail, __ATOMIC_ACQUIRE);
+		if ( rd->head == rd->tail_cache )
+			return __atomic_load_n(&rd->running, __ATOMIC_ACQUIRE) ? 0 : -1;
+	}
+	
+	memcpy(buf, rd->frames + ( rd->head & rd->mask ) * rd->frame_size, rd->frame_size);
+	__atomic_store_n(&rd->head, rd->head + 1, __ATOMIC_RELEASE);
+	
+	return rd->frame_size;
+}
+
+/**
+ * Stop a connection's background reader thread and free its queue.
+ * Frames still queued are discarded.  Called automatically by ino_close().
+ * The queue is kept while a thread that cannot be woken or joined may use it.
+ * @param cnx Pointer to ino_connection_t object with a running reader.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int
+ino_reader_stop(ino_connection_t *cnx)
+{
+	ino_reader_t *rd;
+	int error = -1;
+	int n;
+	
+	if ( cnx && cnx->reader )
+	{
+		rd = cnx->reader;
+		/* wake the thread */
+		do
+			n = write(rd->wake[1], "", 1);
+		while ( n < 0 && errno == EINTR );
+		/* a thread that could not be woken may still be using the queue, keep it */
+		if ( n != 1 && __atomic_load_n(&rd->running, __ATOMIC_ACQUIRE) ) return -1;
+		/* wait for it to finish before freeing what it uses */
+		if ( pthread_join(rd->thread, NULL) != 0 ) return -1;
+		close(rd->wake[0]);
+		close(rd->wake[1]);
+		free(rd->frames);
+		free(rd);
+		cnx->reader = NULL;
+		error = 0;
+	}
+	
+	return error;
+}
+
+#ifdef __linux__
+/**
+ * Finish with the connection whose callbacks were just run, freeing it if
+ * one of them destroyed it and no outer dispatch still refers to it.
+ * @param d Dispatch record of the current dispatch.
+ * @since 0.2
+ */
+static void
+ino_dispatch_done(struct _ino_dispatch_s *d)
+{
+	struct _ino_dispatch_s *o;
+	ino_connection_t *cnx = d->cnx;
+	
+	d->cnx = NULL;
+	if ( !d->destroyed ) return;
+	d->destroyed = 0;
+	
+	for(o=d->outer; o; o=o->outer)
+	{
+		if ( o->cnx == cnx )
+		{
+			o->destroyed = 1;
+			return;
+		}
+	}
+	ino_connection_free(cnx);
+}
+
+/**
+ * Hand the complete frames in a connection's input buffer to its callback.
+ * Raw connections get every complete raw_size frame; character connections
+ * in line mode get every complete line, and canonical ones the bytes of their
+ * latest read, which canonical mode limits to a line.
+ * @param cnx Pointer to a registered ino_connection_t object.
+ * @param nread Number of bytes the latest read added to the buffer.
+ * @return The number of frames dispatched.
+ * @since 0.2
+ */
+static int
+ino_deliver(ino_connection_t *cnx, int nread)
+{
+	int frames = 0;			/* frames dispatched */
+	int len;						/* length of the next line including its new line */
+	uint8_t *line;
+	uint8_t *nl;				/* new line character */
+	
+	if ( cnx->raw && cnx->raw_size > 0 )
+	{
+		/* hand over every complete fixed-size frame */
+		while ( cnx->fd > -1 && cnx->in_tail - cnx->in_head >= cnx->raw_size )
+		{
+			cnx->in_head += cnx->raw_size;
+			cnx->frame_cb(cnx, cnx->in_buf + cnx->in_head - cnx->raw_size, cnx->raw_size, cnx->frame_arg);
+			frames++;
+		}
+	}
+	else if ( cnx->lines && !cnx->raw )
+	{
+		/* hand over every complete line, keeping a partial one for the next read */
+		while ( cnx->fd > -1 && cnx->in_head < cnx->in_tail )
+		{
+			line = cnx->in_buf + cnx->in_head;
+			nl = (uint8_t *)memchr(line, '\n', cnx->in_tail - cnx->in_head);
+			if ( nl )
+				len = nl - line + 1;
+			else if ( cnx->in_head == 0 && cnx->in_tail == cnx->in_size )
+				len = cnx->in_size;		/* a line filling the whole buffer goes as it is */
+			else
+				break;
+			cnx->in_head += len;
+			cnx->frame_cb(cnx, line, len, cnx->frame_arg);
+			frames++;
+		}
+	}
+	else if ( nread > 0 )
+	{
+		/* canonical reads return one line each */
+		cnx->in_head = cnx->in_tail;
+		cnx->frame_cb(cnx, cnx->in_buf + cnx->in_tail - nread, nread, cnx->frame_arg);
+		frames++;
+	}
+	
+	/* rewind an emptied buffer, unless the callback closed the connection */
+	if ( cnx->fd > -1 && cnx->in_head == cnx->in_tail ) cnx->in_head = cnx->in_tail = 0;
+	
+	return frames;
+}
+
+/**
+ * Slide a partial frame to the front of the input buffer to make the most room.
+ * @param cnx Pointer to ino_connection_t object.
+ * @since 0.2
+ */
+static void
+ino_compact(ino_connection_t *cnx)
+{
+	if ( cnx->in_head > 0 )
+	{
+		memmove(cnx->in_buf, cnx->in_buf + cnx->in_head, cnx->in_tail - cnx->in_head);
+		cnx->in_tail -= cnx->in_head;
+		cnx->in_head = 0;
+	}
+}
+
+/**
+ * Drain a readable connection into its input buffer and dispatch its frames.
+ * @param cnx Pointer to a registered ino_connection_t object.
+ * @return The number of frames dispatched, or -1 if the port hung up or failed.
+ * @since 0.2
+ */
+static int
+ino_poller_dispatch(ino_connection_t *cnx)
+{
+	int n = 0;					/* bytes returned by read() */
+	int space = 0;			/* free bytes behind the buffered data */
+	int frames = 0;			/* frames dispatched */
+	
+	if ( ino_set_nonblock(cnx, 1) == -1 ) return -1;
+	
+	do
+	{
+		ino_compact(cnx);
+		space = cnx->in_size - cnx->in_tail;
+		n = read(cnx->fd, cnx->in_buf + cnx->in_tail, space);
+		if ( n > 0 ) cnx->in_tail += n;
+		frames += ino_deliver(cnx, n);
+		/* the callback may have closed the connection */
+		if ( cnx->fd == -1 ) return frames;
+	}
+	while ( n == space || ( n < 0 && errno == EINTR ) );
+	
+	if ( n == 0 || ( n < 0 && errno != EAGAIN && errno != EWOULDBLOCK ) ) return -1;
+	
+	return frames;
+}
+
+/**
+ * Create a new reactor for servicing many Arduino connections from one thread.
+ * Register open connections with ino_poller_add() and call ino_poller_wait()
+ * in a loop.  Each time a port becomes readable the poller drains it into the
+ * connection's input buffer and hands every complete frame to the connection's
+ * callback: raw_size bytes at a time for raw connections, or one line at a
+ * time for character connections.  Must be freed with ino_poller_destroy().
+ * @return Pointer to new ino_poller_t object, or NULL on error.
+ * @since 0.2
+ */
+ino_poller_t *
+ino_poller_new(void)
+{
+	ino_poller_t *poller = NULL;
+	
+	poller = (ino_poller_t *)malloc(sizeof(ino_poller_t));
+	if ( poller )
+	{
+		poller->epfd = epoll_create1(EPOLL_CLOEXEC);
+		if ( poller->epfd == -1 )
+		{
+			free(poller);
+			poller = NULL;
+		}
+	}
+	
+	return poller;
+}
+
+/**
+ * Free a reactor created with ino_poller_new().
+ * Registered connections are left open and must be destroyed separately.
+ * @param poller Pointer to ino_poller_t object to be destroyed.
+ * @since 0.2
+ */
+void
+ino_poller_destroy(ino_poller_t *poller)
+{
+	if ( poller )
+	{
+		close(poller->epfd);
+		free(poller);
+	}
+}
+
+/**
+ * Register an open connection and its frame callback with a reactor.
+ * The port is switched to non-blocking mode.  Closing the connection with
+ * ino_close() removes it from the poller automatically.
+ * @param poller Pointer to ino_poller_t object.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @param cb Function called with each complete frame.
+ * @param arg User argument passed to cb.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int
+ino_poller_add(ino_poller_t *poller, ino_connection_t *cnx, ino_frame_cb cb, void *arg)
+{
+	int error = -1;
+	struct epoll_event ev;
+	
+	if ( poller && cb && cnx && cnx->fd > -1 )
+	{
+		/* make sure a whole frame fits in the input buffer */
+		if ( ino_reserve(cnx, cnx->raw_size) == -1 ) return -1;
+		if ( ino_set_nonblock(cnx, 1) == -1 ) return -1;
+		
+		memset(&ev, 0, sizeof(ev));
+		ev.events = EPOLLIN;
+		ev.data.ptr = cnx;
+		error = epoll_ctl(poller->epfd, EPOLL_CTL_ADD, cnx->fd, &ev);
+		if ( error == 0 )
+		{
+			cnx->frame_cb = cb;
+			cnx->frame_arg = arg;
+		}
+	}
+	
+	return error;
+}
+
+/**
+ * Remove a connection from a reactor without closing it.
+ * @param poller Pointer to ino_poller_t object.
+ * @param cnx Pointer to a registered ino_connection_t object.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int
+ino_poller_remove(ino_poller_t *poller, ino_connection_t *cnx)
+{
+	int error = -1;
+	
+	if ( poller && cnx && cnx->fd > -1 )
+	{
+		error = epoll_ctl(poller->epfd, EPOLL_CTL_DEL, cnx->fd, NULL);
+		cnx->frame_cb = NULL;
+		cnx->frame_arg = NULL;
+	}
+	
+	return error;
+}
+
+/**
+ * Wait for registered connections to become readable and dispatch their frames.
+ * Blocks up to timeout_ms milliseconds, or indefinitely if timeout_ms is -1,
+ * then services every ready connection, invoking its callback once per
+ * complete frame.  Partial frames stay buffered until the rest arrives.
+ * A connection that hangs up or fails is removed from the poller after its
+ * callback is told so.
+ * @param poller Pointer to ino_poller_t object.
+ * @param timeout_ms Milliseconds to wait, 0 to return immediately, -1 forever.
+ * @return The number of frames dispatched, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_poller_wait(ino_poller_t *poller, int timeout_ms)
+{
+	int nready;					/* connections ready */
+	int frames = 0;			/* frames dispatched */
+	int j, n;
+	ino_connection_t *cnx;
+	ino_frame_cb cb;
+	void *arg;
+	struct _ino_dispatch_s d;
+	
+	if ( !poller ) return -1;
+	
+	nready = epoll_wait(poller->epfd, poller->events, INO_POLLER_MAX_EVENTS, timeout_ms);
+	if ( nready == -1 ) return errno == EINTR ? 0 : -1;
+	
+	/* for each ready connection */
+	ino_dispatch_enter(&d, poller);
+	for(j=0; j<nready; j++)
+	{
+		cnx = (ino_connection_t *)poller->events[j].data.ptr;
+		/* skip connections closed or destroyed by an earlier callback */
+		if ( !cnx || cnx->fd == -1 || !cnx->frame_cb ) continue;
+		
+		d.cnx = cnx;
+		n = ino_poller_dispatch(cnx);
+		if ( n == -1 )
+		{
+			/* tell the application, then stop watching the dead port */
+			cb = cnx->frame_cb;
+			arg = cnx->frame_arg;
+			ino_poller_remove(poller, cnx);
+			cb(cnx, NULL, -1, arg);
+		}
+		else
+			frames += n;
+		ino_dispatch_done(&d);
+	}
+	ino_dispatch_leave(&d);
+	
+	return frames;
+}
+
+/* io_uring request kinds, kept in the low bits of each request's user_data */
+#define INO_URING_OP_READ 1
+#define INO_URING_OP_WRITE 2
+#define INO_URING_OP_CANCEL 3
+#define INO_URING_OP_MASK 3
+
+/**
+ * Data type for an io_uring I/O engine driving many Arduino connections.
+ * @since 0.2
+ */
+struct _ino_uring_s
+{
+	int fd;												/* io_uring instance */
+	unsigned *sq_head;						/* submission ring, consumed by the kernel */
+	unsigned *sq_tail;						/* submission ring, produced by us */
+	unsigned *sq_mask;
+	unsigned *sq_entries;
+	unsigned *sq_array;
+	struct io_uring_sqe *sqes;		/* submission queue entries */
+	unsigned *cq_head;						/* completion ring, consumed by us */
+	unsigned *cq_tail;						/* completion ring, produced by the kernel */
+	unsigned *cq_mask;
+	struct io_uring_cqe *cqes;		/* completion queue entries */
+	void *sq_ring;								/* mapping of the submission ring */
+	size_t sq_ring_size;
+	void *cq_ring;								/* mapping of the completion ring, may equal sq_ring */
+	size_t cq_ring_size;
+	size_t sqes_size;
+	unsigned pending;							/* entries queued but not yet submitted */
+	struct _ino_uring_slot_s *slots;	/* attached connections */
+	struct _ino_uring_slot_s *dirty;	/* attached connections with output waiting */
+	struct __kernel_timespec timeout;	/* timeout for ino_uring_wait() */
+};
+
+/**
+ * Data type for the state of a connection attached to an ino_uring_t.
+ * Output is staged in one buffer while the kernel writes the other, so the
+ * bytes of a connection always go out in order with at most one write in
+ * flight.
+ * @since 0.2
+ */
+struct _ino_uring_slot_s
+{
+	ino_uring_t *uring;						/* engine the connection is attached to */
+	ino_connection_t *cnx;				/* attached connection */
+	uint8_t *wbuf;								/* bytes being written by the kernel */
+	int wlen;
+	int wsize;
+	uint8_t *sbuf;								/* bytes staged for the next write */
+	int slen;
+	int ssize;
+	int reading;									/* 1 while a read is posted */
+	int writing;									/* 1 while a write is posted */
+	int canceling;								/* 1 while a cancel of the read is posted */
+	int dead;											/* 1 after the port hung up or failed */
+	int removing;									/* 1 while being detached */
+	int dirty;										/* 1 while on the engine's dirty list */
+	struct _ino_uring_slot_s *next;	/* next attached connection */
+	struct _ino_uring_slot_s *next_dirty;	/* next connection with output waiting */
+};
+
+/**
+ * Enter the kernel to submit queued entries and optionally wait for completions.
+ * @param uring Pointer to ino_uring_t object.
+ * @param min_complete Number of completions to wait for.
+ * @return The number of entries submitted, or -1 on error.
+ * @since 0.2
+ */
+static int
+ino_uring_enter(ino_uring_t *uring, unsigned min_complete)
+{
+	int n;
+	
+	do
+		n = syscall(__NR_io_uring_enter, uring->fd, uring->pending, min_complete,
+			min_complete ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+	while ( n < 0 && errno == EINTR && min_complete == 0 );
+	
+	if ( n > 0 ) uring->pending -= n;
+	if ( n < 0 && errno == EINTR ) n = 0;
+	
+	return n;
+}
+
+/**
+ * Get a cleared submission queue entry, submitting queued ones if the ring is full.
+ * @param uring Pointer to ino_uring_t object.
+ * @param user_data Value identifying the request on completion.
+ * @return Pointer to the entry, or NULL on error.
+ * @since 0.2
+ */
+static struct io_uring_sqe *
+ino_uring_sqe(ino_uring_t *uring, uint64_t user_data)
+{
+	struct io_uring_sqe *sqe;
+	unsigned tail = *uring->sq_tail;
+	unsigned idx;
+	
+	if ( tail - __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE) >= *uring->sq_entries )
+	{
+		if ( ino_uring_enter(uring, 0) < 0 ) return NULL;
+		if ( tail - __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE) >= *uring->sq_entries ) return NULL;
+	}
+	
+	idx = tail & *uring->sq_mask;
+	sqe = &uring->sqes[idx];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->user_data = user_data;
+	uring->sq_array[idx] = idx;
+	__atomic_store_n(uring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	uring->pending++;
+	
+	return sqe;
+}
+
+/**
+ * Post a read into the free end of a connection's input buffer.
+ * @param slot Pointer to the connection's attachment.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+static int
+ino_uring_post_read(struct _ino_uring_slot_s *slot)
+{
+	ino_connection_t *cnx = slot->cnx;
+	struct io_uring_sqe *sqe;
+	
+	ino_compact(cnx);
+	sqe = ino_uring_sqe(slot->uring, (uint64_t)(uintptr_t)slot | INO_URING_OP_READ);
+	if ( !sqe ) return -1;
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = cnx->fd;
+	sqe->addr = (uint64_t)(uintptr_t)( cnx->in_buf + cnx->in_tail );
+	sqe->len = cnx->in_size - cnx->in_tail;
+	sqe->off = (uint64_t)-1;
+	slot->reading = 1;
+	
+	return 0;
+}
+
+/**
+ * Post a write of a connection's staged output.
+ * @param slot Pointer to the connection's attachment.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+static int
+ino_uring_post_write(struct _ino_uring_slot_s *slot)
+{
+	struct io_uring_sqe *sqe;
+	uint8_t *buf;
+	int size;
+	
+	/* swap the staged bytes into the in-flight buffer */
+	if ( slot->wlen == 0 )
+	{
+		buf = slot->wbuf; slot->wbuf = slot->sbuf; slot->sbuf = buf;
+		size = slot->wsize; slot->wsize = slot->ssize; slot->ssize = size;
+		slot->wlen = slot->slen;
+		slot->slen = 0;
+	}
+	
+	sqe = ino_uring_sqe(slot->uring, (uint64_t)(uintptr_t)slot | INO_URING_OP_WRITE);
+	if ( !sqe ) return -1;
+	sqe->opcode = IORING_OP_WRITE;
+	sqe->fd = slot->cnx->fd;
+	sqe->addr = (uint64_t)(uintptr_t)slot->wbuf;
+	sqe->len = slot->wlen;
+	sqe->off = (uint64_t)-1;
+	slot->writing = 1;
+	
+	return 0;
+}
+
+/**
+ * Queue bytes for an attached connection's next write.
+ * @param cnx Pointer to an attached ino_connection_t object.
+ * @param buf Bytes to send.
+ * @param nbytes Number of bytes to send.
+ * @return nbytes, or -1 on error.
+ * @since 0.2
+ */
+static int
+ino_uring_stage(ino_connection_t *cnx, const uint8_t *buf, int nbytes)
+{
+	struct _ino_uring_slot_s *slot = cnx->uring;
+	uint8_t *sbuf;
+	int size;
+	
+	if ( slot->dead ) return -1;
+	
+	if ( slot->slen + nbytes > slot->ssize )
+	{
+		size = slot->ssize ? slot->ssize : 64;
+		while ( size < slot->slen + nbytes ) size *= 2;
+		sbuf = (uint8_t *)realloc(slot->sbuf, size);
+		if ( !sbuf ) return -1;
+		slot->sbuf = sbuf;
+		slot->ssize = size;
+	}
+	memcpy(slot->sbuf + slot->slen, buf, nbytes);
+	slot->slen += nbytes;
+	
+	/* remember to post a write at the next submit */
+	if ( !slot->dirty )
+	{
+		slot->dirty = 1;
+		slot->next_dirty = slot->uring->dirty;
+		slot->uring->dirty = slot;
+	}
+	
+	return nbytes;
+}
+
+/**
+ * Post writes for every connection with staged output and no write in flight.
+ * @param uring Pointer to ino_uring_t object.
+ * @since 0.2
+ */
+static void
+ino_uring_post_writes(ino_uring_t *uring)
+{
+	struct _ino_uring_slot_s *slot;
+	struct _ino_uring_slot_s *keep = NULL;		/* connections still waiting */
+	
+	while ( uring->dirty )
+	{
+		slot = uring->dirty;
+		uring->dirty = slot->next_dirty;
+		if ( slot->slen > 0 && !slot->dead && ( slot->writing || ino_uring_post_write(slot) == -1 ) )
+		{
+			/* a write is still in flight, try again after it completes */
+			slot->next_dirty = keep;
+			keep = slot;
+		}
+		else
+			slot->dirty = 0;
+	}
+	uring->dirty = keep;
+}
+
+/**
+ * Process every available completion.
+ * @param uring Pointer to ino_uring_t object.
+ * @return The number of frames dispatched.
+ * @since 0.2
+ */
+static int
+ino_uring_reap(ino_uring_t *uring)
+{
+	struct io_uring_cqe *cqe;
+	struct _ino_uring_slot_s *slot;
+	ino_connection_t *cnx;
+	unsigned head;
+	int frames = 0;
+	int op, res;
+	struct _ino_dispatch_s d;
+	
+	ino_dispatch_enter(&d, NULL);
+	/* callbacks may reap recursively, so always start from the shared head */
+	while ( ( head = *uring->cq_head ) != __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE) )
+	{
+		cqe = &uring->cqes[head & *uring->cq_mask];
+		op = cqe->user_data & INO_URING_OP_MASK;
+		slot = (struct _ino_uring_slot_s *)(uintptr_t)( cqe->user_data & ~(uint64_t)INO_URING_OP_MASK );
+		res = cqe->res;
+		/* release the entry before callbacks can queue more */
+		__atomic_store_n(uring->cq_head, head + 1, __ATOMIC_RELEASE);
+		
+		/* timeouts carry no connection */
+		if ( !slot ) continue;
+		cnx = slot->cnx;
+		
+		if ( op == INO_URING_OP_CANCEL )
+			slot->canceling = 0;
+		else if ( op == INO_URING_OP_WRITE )
+		{
+			slot->writing = 0;
+			if ( res > 0 && res < slot->wlen )
+			{
+				/* short write, send the rest first */
+				memmove(slot->wbuf, slot->wbuf + res, slot->wlen - res);
+				slot->wlen -= res;
+			}
+			else
+				slot->wlen = 0;
+			if ( ( slot->wlen > 0 || slot->slen > 0 ) && !slot->dead && !slot->removing )
+				ino_uring_post_write(slot);
+		}
+		else if ( op == INO_URING_OP_READ )
+		{
+			slot->reading = 0;
+			d.cnx = cnx;
+			if ( res > 0 )
+			{
+				cnx->in_tail += res;
+				frames += ino_deliver(cnx, res);
+			}
+			/* the callback may have closed or destroyed the connection and freed the slot */
+			if ( cnx->uring == slot && res != -ECANCELED && !slot->removing && cnx->fd > -1 )
+			{
+				if ( res == 0 || ( res < 0 && res != -EAGAIN && res != -EINTR ) )
+				{
+					/* tell the application the port is gone */
+					slot->dead = 1;
+					cnx->frame_cb(cnx, NULL, -1, cnx->frame_arg);
+				}
+				else
+					ino_uring_post_read(slot);
+			}
+			ino_dispatch_done(&d);
+		}
+	}
+	ino_dispatch_leave(&d);
+	
+	return frames;
+}
+
+/**
+ * Create a new io_uring I/O engine for many Arduino connections.
+ * Attach open connections with ino_uring_add() and call ino_uring_wait() in a
+ * loop.  The engine keeps a read posted on every attached port so input lands
+ * in the connection's input buffer without a read() per wakeup, and it
+ * collects the output of the ino_send_*() functions, submitting the writes of
+ * all connections together with a single syscall.  If the kernel lacks
+ * io_uring, or it has been disabled, NULL is returned and the application
+ * should keep using read()/write() through ino_poller_t and the ordinary
+ * read functions instead.  Must be freed with ino_uring_destroy().
+ * @param entries Submission queue size; at least two per connection is advised.
+ * @return Pointer to new ino_uring_t object, or NULL if io_uring is unavailable.
+ * @since 0.2
+ */
+ino_uring_t *
+ino_uring_new(unsigned entries)
+{
+	ino_uring_t *uring = NULL;
+	struct io_uring_params params;
+	struct io_uring_probe *probe;
+	size_t probe_size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+	int usable;
+	uint8_t *sq, *cq;
+	
+	uring = (ino_uring_t *)calloc(1, sizeof(ino_uring_t));
+	if ( !uring ) return NULL;
+	
+	memset(&params, 0, sizeof(params));
+	uring->fd = syscall(__NR_io_uring_setup, entries, &params);
+	if ( uring->fd < 0 )
+	{
+		free(uring);
+		return NULL;
+	}
+	
+	/* make sure the kernel knows plain reads and writes */
+	probe = (struct io_uring_probe *)calloc(1, probe_size);
+	usable = probe && syscall(__NR_io_uring_register, uring->fd, IORING_REGISTER_PROBE, probe, 256) == 0
+		&& probe->last_op >= IORING_OP_WRITE
+		&& ( probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED )
+		&& ( probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED );
+	free(probe);
+	
+	/* map the rings */
+	uring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	uring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if ( params.features & IORING_FEAT_SINGLE_MMAP )
+	{
+		if ( uring->cq_ring_size > uring->sq_ring_size ) uring->sq_ring_size = uring->cq_ring_size;
+		uring->cq_ring_size = uring->sq_ring_size;
+	}
+	uring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	uring->sq_ring = MAP_FAILED;
+	uring->cq_ring = MAP_FAILED;
+	uring->sqes = MAP_FAILED;
+	if ( usable )
+	{
+		uring->sq_ring = mmap(NULL, uring->sq_ring_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQ_RING);
+		if ( params.features & IORING_FEAT_SINGLE_MMAP )
+			uring->cq_ring = uring->sq_ring;
+		else
+			uring->cq_ring = mmap(NULL, uring->cq_ring_size, PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_CQ_RING);
+		uring->sqes = (struct io_uring_sqe *)mmap(NULL, uring->sqes_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQES);
+	}
+	if ( uring->sq_ring == MAP_FAILED || uring->cq_ring == MAP_FAILED || uring->sqes == MAP_FAILED )
+	{
+		if ( uring->sqes != MAP_FAILED ) munmap(uring->sqes, uring->sqes_size);
+		if ( uring->cq_ring != MAP_FAILED && uring->cq_ring != uring->sq_ring )
+			munmap(uring->cq_ring, uring->cq_ring_size);
+		if ( uring->sq_ring != MAP_FAILED ) munmap(uring->sq_ring, uring->sq_ring_size);
+		close(uring->fd);
+		free(uring);
+		return NULL;
+	}
+	
+	sq = (uint8_t *)uring->sq_ring;
+	cq = (uint8_t *)uring->cq_ring;
+	uring->sq_head = (unsigned *)( sq + params.sq_off.head );
+	uring->sq_tail = (unsigned *)( sq + params.sq_off.tail );
+	uring->sq_mask = (unsigned *)( sq + params.sq_off.ring_mask );
+	uring->sq_entries = (unsigned *)( sq + params.sq_off.ring_entries );
+	uring->sq_array = (unsigned *)( sq + params.sq_off.array );
+	uring->cq_head = (unsigned *)( cq + params.cq_off.head );
+	uring->cq_tail = (unsigned *)( cq + params.cq_off.tail );
+	uring->cq_mask = (unsigned *)( cq + params.cq_off.ring_mask );
+	uring->cqes = (struct io_uring_cqe *)( cq + params.cq_off.cqes );
+	
+	return uring;
+}
+
+/**
+ * Free an io_uring engine created with ino_uring_new().
+ * Every attached connection is detached first, so all of them fall back to
+ * read()/write(); the connections themselves stay open.
+ * @param uring Pointer to ino_uring_t object to be destroyed.
+ * @since 0.2
+ */
+void
+ino_uring_destroy(ino_uring_t *uring)
+{
+	if ( uring )
+	{
+		while ( uring->slots ) ino_uring_remove(uring->slots->cnx);
+		munmap(uring->sqes, uring->sqes_size);
+		if ( uring->cq_ring != uring->sq_ring ) munmap(uring->cq_ring, uring->cq_ring_size);
+		munmap(uring->sq_ring, uring->sq_ring_size);
+		close(uring->fd);
+		free(uring);
+	}
+}
+
+/**
+ * Attach an open connection and its frame callback to an io_uring engine.
+ * From then on the connection's input is only delivered through cb, in the
+ * same way as for ino_poller_add(), and ino_send_*() output is queued for
+ * the engine to submit on the next ino_uring_submit() or ino_uring_wait().
+ * Closing the connection with ino_close() detaches it automatically.
+ * @param uring Pointer to ino_uring_t object.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @param cb Function called with each complete frame.
+ * @param arg User argument passed to cb.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int
+ino_uring_add(ino_uring_t *uring, ino_connection_t *cnx, ino_frame_cb cb, void *arg)
+{
+	struct _ino_uring_slot_s *slot;
+	
+	if ( !uring || !cb || !cnx || cnx->fd == -1 || cnx->uring || cnx->reader ) return -1;
+	/* make sure a whole frame fits in the input buffer */
+	if ( ino_reserve(cnx, cnx->raw_size) == -1 ) return -1;
+	
+	slot = (struct _ino_uring_slot_s *)calloc(1, sizeof(struct _ino_uring_slot_s));
+	if ( !slot ) return -1;
+	slot->uring = uring;
+	slot->cnx = cnx;
+	cnx->frame_cb = cb;
+	cnx->frame_arg = arg;
+	
+	if ( ino_uring_post_read(slot) == -1 )
+	{
+		free(slot);
+		return -1;
+	}
+	cnx->uring = slot;
+	slot->next = uring->slots;
+	uring->slots = slot;
+	
+	return 0;
+}
+
+/**
+ * Detach a connection from its io_uring engine without closing it.
+ * Cancels the posted read and waits for the connection's outstanding requests
+ * to finish; queued output that was never submitted is sent with write().
+ * Other connections' frames may be dispatched while waiting.
+ * @param cnx Pointer to an attached ino_connection_t object.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int
+ino_uring_remove(ino_connection_t *cnx)
+{
+	struct _ino_uring_slot_s *slot;
+	struct _ino_uring_slot_s **link;
+	struct io_uring_sqe *sqe;
+	ino_uring_t *uring;
+	int error = 0;
+	
+	if ( !cnx || !cnx->uring || cnx->uring->removing ) return -1;
+	slot = cnx->uring;
+	uring = slot->uring;
+	slot->removing = 1;
+	
+	/* cancel the posted read */
+	if ( slot->reading )
+	{
+		sqe = ino_uring_sqe(uring, (uint64_t)(uintptr_t)slot | INO_URING_OP_CANCEL);
+		if ( sqe )
+		{
+			sqe->opcode = IORING_OP_ASYNC_CANCEL;
+			sqe->addr = (uint64_t)(uintptr_t)slot | INO_URING_OP_READ;
+			slot->canceling = 1;
+		}
+	}
+	
+	/* the kernel may still touch our buffers until every request completes */
+	while ( slot->reading || slot->writing || slot->canceling )
+	{
+		if ( ino_uring_enter(uring, 1) < 0 && errno != EINTR )
+		{
+			error = -1;
+			break;
+		}
+		ino_uring_reap(uring);
+	}
+	
+	/* unlink from the engine's lists */
+	for(link = &uring->slots; *link; link = &(*link)->next)
+		if ( *link == slot ) { *link = slot->next; break; }
+	for(link = &uring->dirty; *link; link = &(*link)->next_dirty)
+		if ( *link == slot ) { *link = slot->next_dirty; break; }
+	cnx->uring = NULL;
+	
+	/* output that never reached the kernel goes out the ordinary way */
+	if ( error == 0 && cnx->fd > -1 && !slot->dead )
+	{
+		if ( slot->wlen > 0 && write(cnx->fd, slot->wbuf, slot->wlen) != slot->wlen ) error = -1;
+		if ( slot->slen > 0 && write(cnx->fd, slot->sbuf, slot->slen) != slot->slen ) error = -1;
+	}
+	
+	if ( error == 0 )
+	{
+		free(slot->wbuf);
+		free(slot->sbuf);
+		free(slot);
+	}
+	
+	return error;
+}
+
+/**
+ * Submit all queued writes and reads without waiting for any to complete.
+ * @param uring Pointer to ino_uring_t object.
+ * @return The number of requests submitted, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_uring_submit(ino_uring_t *uring)
+{
+	if ( !uring ) return -1;
+	
+	ino_uring_post_writes(uring);
+	
+	return uring->pending ? ino_uring_enter(uring, 0) : 0;
+}
+
+/**
+ * Submit queued requests, wait for completions and dispatch incoming frames.
+ * Blocks up to timeout_ms milliseconds, or indefinitely if timeout_ms is -1,
+ * for at least one request to complete, then processes every completion:
+ * frames are handed to their connection's callback and reads are posted
+ * again.  A connection that hangs up or fails is told so through its
+ * callback and stays attached, idle, until it is removed or closed.
+ * @param uring Pointer to ino_uring_t object.
+ * @param timeout_ms Milliseconds to wait, 0 to return immediately, -1 forever.
+ * @return The number of frames dispatched, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_uring_wait(ino_uring_t *uring, int timeout_ms)
+{
+	struct io_uring_sqe *sqe;
+	
+	if ( !uring ) return -1;
+	
+	ino_uring_post_writes(uring);
+	
+	/* a timeout that also completes as soon as anything else does */
+	if ( timeout_ms > 0 )
+	{
+		uring->timeout.tv_sec = timeout_ms / 1000;
+		uring->timeout.tv_nsec = ( timeout_ms % 1000 ) * 1000000L;
+		sqe = ino_uring_sqe(uring, 0);
+		if ( !sqe ) return -1;
+		sqe->opcode = IORING_OP_TIMEOUT;
+		sqe->addr = (uint64_t)(uintptr_t)&uring->timeout;
+		sqe->len = 1;
+		sqe->off = 1;
+	}
+	
+	if ( ( uring->pending || timeout_ms != 0 ) && ino_uring_enter(uring, timeout_ms == 0 ? 0 : 1) < 0 )
+		return -1;
+	
+	return ino_uring_reap(uring);
+}
+#endif
+
+#ifdef __linux__
+/* states of a device present in a watched directory */
+#define INO_PRESENT_KNOWN 0
+#define INO_PRESENT_ADDED 1
+#define INO_PRESENT_CHANGED 2
+
+/**
+ * Data type for a connection attached to an ino_watcher_t.
+ * @since 0.2
+ */
+struct _ino_watch_s
+{
+	struct _ino_watch_s *next;
+	ino_connection_t *cnx;						/* attached connection */
+	char *port;												/* port the connection had before it was attached */
+	char id[INO_DEVICE_ID_SIZE];			/* identity of the device to attach to */
+	char path[INO_DEVICE_PATH_SIZE];	/* node the connection is pointed at */
+};
+
+/**
+ * Data type for a device present in a directory watched by an ino_watcher_t.
+ * @since 0.2
+ */
+struct _ino_present_s
+{
+	ino_device_t dev;
+	int state;												/* one of the INO_PRESENT_ constants */
+	int seen;													/* 1 if found by the latest rescan */
+};
+
+/**
+ * Data type for a watcher that attaches connections to devices as they are plugged in.
+ * @since 0.2
+ */
+struct _ino_watcher_s
+{
+	int fd;														/* inotify instance */
+	char dir[INO_DEVICE_PATH_SIZE];		/* watched directory */
+	ino_device_cb cb;
+	void *arg;
+	struct _ino_watch_s *watches;			/* attached connections */
+	struct _ino_present_s *present;		/* devices in the directory */
+	int npresent;
+	int present_size;
+	int scanned;											/* 1 once the devices already present were reported */
+};
+
+/**
+ * Read a one line sysfs attribute.
+ * @param dir Sysfs directory.
+ * @param name Attribute name.
+ * @param buf Filled with the value, without the new line.
+ * @param size Capacity of buf.
+ * @return The length of the value, or -1 if there is no such attribute.
+ * @since 0.2
+ */
+static int
+ino_sysfs_read(const char *dir, const char *name, char *buf, int size)
+{
+	char path[PATH_MAX];
+	int fd, n;
+	
+	if ( snprintf(path, sizeof(path), "%s/%s", dir, name) >= (int)sizeof(path) ) return -1;
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if ( fd == -1 ) return -1;
+	do n = read(fd, buf, size - 1); while ( n < 0 && errno == EINTR );
+	close(fd);
+	if ( n < 0 ) return -1;
+	
+	while ( n > 0 && ( buf[n - 1] == '\n' || buf[n - 1] == ' ' ) ) n--;
+	buf[n] = '\0';
+	
+	return n;
+}
+
+/**
+ * Find out whether a directory entry is a serial device and identify it.
+ * @param dir Directory of device nodes.
+ * @param name Name of the entry in dir.
+ * @param dev Filled with the device's node and identity.
+ * @return 1 if the entry is a serial device or pty, 0 if not.
+ * @since 0.2
+ */
+static int
+ino_device_probe(const char *dir, const char *name, ino_device_t *dev)
+{
+	char real[PATH_MAX];		/* node with symlinks resolved */
+	char sys[PATH_MAX];			/* sysfs directory of the tty's device */
+	char path[PATH_MAX];
+	char val[64];
+	struct stat st;
+	int i;
+	
+	if ( name[0] == '.' ) return 0;
+	if ( snprintf(dev->path, sizeof(dev->path), "%s/%s", dir, name) >= (int)sizeof(dev->path) ) return 0;
+	if ( stat(dev->path, &st) == -1 || !S_ISCHR(st.st_mode) || !realpath(dev->path, real) ) return 0;
+	
+	dev->vid = -1;
+	dev->pid = -1;
+	dev->serial[0] = '\0';
+	snprintf(dev->id, sizeof(dev->id), "%s", name);
+	
+	/* ptys have no sysfs entry, they stand in for boards in tests */
+	if ( strncmp(real, "/dev/pts/", 9) == 0 ) return 1;
+	
+	/* virtual consoles and other ttys without hardware have no device */
+	snprintf(path, sizeof(path), "/sys/class/tty/%s/device", strrchr(real, '/') + 1);
+	if ( !realpath(path, sys) ) return 0;
+	/* legacy 8250 UARTs are listed whether or not they exist */
+	if ( snprintf(path, sizeof(path), "%s/subsystem", sys) < (int)sizeof(path)
+		&& realpath(path, real) && strcmp(strrchr(real, '/'), "/platform") == 0 )
+		return 0;
+	
+	/* walk up from the tty's interface to its USB device */
+	for(i=0; i<4; i++)
+	{
+		if ( ino_sysfs_read(sys, "idVendor", val, sizeof(val)) > 0 )
 		{
-			/* shift existing bits to make room for next byte */
-			tmp.unsig <<= 8;
-			/* add the bits of the next byte to the end of working tmp */
-			tmp.unsig |= frame[j];
+			dev->vid = (int)strtol(val, NULL, 16);
+			if ( ino_sysfs_read(sys, "idProduct", val, sizeof(val)) > 0 ) dev->pid = (int)strtol(val, NULL, 16);
+			if ( ino_sysfs_read(sys, "serial", dev->serial, sizeof(dev->serial)) <= 0 ) dev->serial[0] = '\0';
+			/* without a serial number the USB port path is as stable as it gets */
+			snprintf(dev->id, sizeof(dev->id), "%04x:%04x:%s", dev->vid, dev->pid,
+				dev->serial[0] ? dev->serial : strrchr(sys, '/') + 1);
+			break;
 		}
+		*strrchr(sys, '/') = '\0';
 	}
-		
-	/* return as unsigned int*/
-	return tmp.unsig;
+	
+	return 1;
 }
 
 /**
- * Read multiple signed 32-bit integers from an Arduino raw connection at once.
- * Reads 4 bytes per integer from the serial port and converts them from network
- * byte order into host byte order and casts them to signed 32-bit integers. 
- * The corresponding Arduino library "send" function will send the integer byte by
- * byte in network byte order.  The function requires an ino_connection_t object
- * created using ino_connection_raw() with a 4 bytes per integer frame size,
- * i.e., three 4-byte integers would require a connection frame size of 12 bytes.
- * @param cnx Pointer to ino_connection_t object from which to read data.
- * @param int_buf Pointer to the beginning of an array of int32_t.
- * @param int_count The number of integers to attempt reading <= array length.
- * @return The number of integers read from the serial port.
- * @since 0.1
+ * List the serial devices present.
+ * Without a directory every tty in /sys/class/tty that is backed by a device,
+ * other than legacy platform UARTs, is listed with its node in /dev, e.g.
+ * ttyACM0, ttyUSB0 or ttyAMA0.  USB devices are identified from sysfs by
+ * vendor id, product id and serial number.  With a directory, e.g.
+ * /dev/serial/by-id or a directory of symlinks to ptys, its entries that are
+ * serial devices or ptys are listed instead.  Ports are not opened, so no
+ * board is reset.
+ * @param dir Directory of device nodes, or NULL for the devices in sysfs.
+ * @param devs Array filled with the devices found.
+ * @param max_devs Capacity of devs.
+ * @return The number of devices stored in devs, or -1 on error.
+ * @since 0.2
  */
 int
-ino_read_int32s(ino_connection_t *cnx, int32_t *int_buf, int int_count)
+ino_discover(const char *dir, ino_device_t *devs, int max_devs)
 {
-  int n;														/* total bytes received */
-  int i=0, j=0, k=0;								/* loop indices */
-  ino_int32 tmp;										/* working tmp int */
-  int frame_size = int_count * 4;		/* number of bytes in frame */
-  unsigned char frame[frame_size];	/* frame buffer */
+	DIR *d;
+	struct dirent *e;
+	int n = 0;
+	
+	if ( !devs || max_devs < 0 ) return -1;
+	
+	d = opendir(dir ? dir : "/sys/class/tty");
+	if ( !d ) return -1;
+	while ( n < max_devs && ( e = readdir(d) ) )
+		if ( ino_device_probe(dir ? dir : "/dev", e->d_name, &devs[n]) ) n++;
+	closedir(d);
+	
+	return n;
+}
 
-	/* if connected */	
-	if ( cnx && cnx->fd > -1 )
-	{
-		/* prepare raw byte buffer */
-		memset(frame,0,frame_size);
-		/* receive frame of int's from arduino */
-		n = read(cnx->fd, frame, frame_size);
-		/* break sets of bytes up into integers */
-		/* for each set of bytes corresponding to an arduino int */
-		for(i=0; i<n; i+=4)
-		{
-			/* init tmp to zero */
-			tmp.unsig = 0;
-			/* for each byte */
-			for(j=0; j<4; j++)
-			{
-				/* shift existing bits to make room for next byte */
-				tmp.unsig <<= 8;
-				/* add the bits of the next byte to the end of working tmp */
-				tmp.unsig |= frame[i+j];
-			}
-			/* convert to signed int and add to int_buf */
-			int_buf[k++] = tmp.sig;
-		}
-	}
-	  
-  /* return the number of integers read */
-  return k;
+/**
+ * Find a device present in the watched directory by the name of its node.
+ * @param watcher Pointer to ino_watcher_t object.
+ * @param name Name of the node in the watched directory.
+ * @return Index of the device in watcher->present, or -1 if not present.
+ * @since 0.2
+ */
+static int
+ino_watcher_find(ino_watcher_t *watcher, const char *name)
+{
+	size_t len = strlen(watcher->dir);
+	int i;
+	
+	for(i=0; i<watcher->npresent; i++)
+		if ( strcmp(watcher->present[i].dev.path + len + 1, name) == 0 ) return i;
+	
+	return -1;
 }
 
 /**
- * Read multiple unsigned 32-bit integers from an Arduino raw connection at once.
- * Reads 4 bytes per integer from the serial port and converts them from network
- * byte order into host byte order and casts them to unsigned 32-bit integers. 
- * The corresponding Arduino library "send" function will send the integer byte by
- * byte in network byte order.  The function requires an ino_connection_t object
- * created using ino_connection_raw() with a 4 bytes per integer frame size,
- * i.e., three 4-byte integers would require a connection frame size of 12 bytes.
- * @param cnx Pointer to ino_connection_t object from which to read data.
- * @param int_buf Pointer to the beginning of an array of uint32_t.
- * @param int_count The number of integers to attempt reading <= array length.
- * @return The number of integers read from the serial port.
- * @since 0.1
+ * Find the connection attached to a device identity.
+ * @param watcher Pointer to ino_watcher_t object.
+ * @param id Stable identity of the device.
+ * @return The attachment, or NULL if none.
+ * @since 0.2
  */
-int
-ino_read_uint32s(ino_connection_t *cnx, uint32_t *int_buf, int int_count)
+static struct _ino_watch_s *
+ino_watcher_lookup(ino_watcher_t *watcher, const char *id)
 {
-  int n;														/* total bytes received */
-  int i=0, j=0, k=0;								/* loop indices */
-  ino_int32 tmp;										/* working tmp int */
-  int frame_size = int_count * 4;		/* number of bytes in frame */
-  unsigned char frame[frame_size];	/* frame buffer */
+	struct _ino_watch_s *watch;
+	
+	for(watch=watcher->watches; watch; watch=watch->next)
+		if ( strcmp(watch->id, id) == 0 ) return watch;
+	
+	return NULL;
+}
 
-	/* if connected */	
-	if ( cnx && cnx->fd > -1 )
-	{
-		/* prepare raw byte buffer */
-		memset(frame,0,frame_size);
-		/* receive frame of int's from arduino */
-		n = read(cnx->fd, frame, frame_size);
-		/* break sets of bytes up into integers */
-		/* for each set of bytes corresponding to an arduino int */
-		for(i=0; i<n; i+=4)
-		{
-			/* init tmp to zero */
-			tmp.unsig = 0;
-			/* for each byte */
-			for(j=0; j<4; j++)
-			{
-				/* shift existing bits to make room for next byte */
-				tmp.unsig <<= 8;
-				/* add the bits of the next byte to the end of working tmp */
-				tmp.unsig |= frame[i+j];
-			}
-			/* take unsigned int value and add to int_buf */
-			int_buf[k++] = tmp.unsig;
-		}
-	}
-	  
-  /* return the number of integers read */
-  return k;
+/**
+ * Forget a device that left the watched directory, closing its connection.
+ * @param watcher Pointer to ino_watcher_t object.
+ * @param i Index of the device in watcher->present.
+ * @since 0.2
+ */
+static void
+ino_watcher_remove(ino_watcher_t *watcher, int i)
+{
+	struct _ino_watch_s *watch;
+	ino_device_t dev = watcher->present[i].dev;
+	int reported = ( watcher->present[i].state != INO_PRESENT_ADDED );
+	
+	watcher->present[i] = watcher->present[--watcher->npresent];
+	
+	watch = ino_watcher_lookup(watcher, dev.id);
+	if ( watch && ino_is_open(watch->cnx) ) ino_close(watch->cnx);
+	if ( reported && watcher->cb ) watcher->cb(&dev, watch ? watch->cnx : NULL, INO_DEVICE_REMOVED, watcher->arg);
 }
 
 /**
- * Send an array of raw bytes to the Arduino through the serial port.
- * Sends an array of uint8_t through the given ino_connection_t/serial port.
- * @param cnx Pointer to ino_connection_t object through which to send data.
- * @param buf Array of uint8_t bytes to send to the Arduino.
- * @param frame_size_bytes The number of bytes to be sent to the Arduino.
- * @return The number of bytes actually sent, or -1 on error.
- * @since 0.1
+ * Bring the record of a node in the watched directory up to date.
+ * @param watcher Pointer to ino_watcher_t object.
+ * @param name Name of the node in the watched directory.
+ * @param mask inotify event mask, or 0 when rescanning.
+ * @return 1 if a reported device was removed, 0 otherwise.
+ * @since 0.2
  */
-int
-ino_send_raw(ino_connection_t *cnx, uint8_t *buf, int frame_size_bytes)
+static int
+ino_watcher_update(ino_watcher_t *watcher, const char *name, uint32_t mask)
 {
-	int n = 0;
+	struct _ino_present_s *p;
+	ino_device_t dev;
+	int i = ino_watcher_find(watcher, name);
+	int found = 0;
+	int removed = 0;
 	
-	/* if connected */	
-	if ( cnx && cnx->fd > -1 )
+	if ( !( mask & ( IN_DELETE | IN_MOVED_FROM ) ) ) found = ino_device_probe(watcher->dir, name, &dev);
+	
+	/* gone, or replaced by a different device */
+	if ( i > -1 && ( !found || strcmp(dev.id, watcher->present[i].dev.id) != 0 ) )
 	{
-		n = write(cnx->fd, buf, frame_size_bytes);
+		removed = ( watcher->present[i].state != INO_PRESENT_ADDED );
+		ino_watcher_remove(watcher, i);
+		i = -1;
 	}
+	if ( !found ) return removed;
 	
-	return n;
+	if ( i > -1 )
+	{
+		watcher->present[i].seen = 1;
+		if ( ( mask & IN_ATTRIB ) && watcher->present[i].state == INO_PRESENT_KNOWN )
+			watcher->present[i].state = INO_PRESENT_CHANGED;
+		return removed;
+	}
+	
+	if ( watcher->npresent == watcher->present_size )
+	{
+		p = (struct _ino_present_s *)realloc(watcher->present, ( watcher->present_size * 2 + 8 ) * sizeof(*p));
+		if ( !p ) return removed;
+		watcher->present = p;
+		watcher->present_size = watcher->present_size * 2 + 8;
+	}
+	p = &watcher->present[watcher->npresent++];
+	p->dev = dev;
+	p->state = INO_PRESENT_ADDED;
+	p->seen = 1;
+	
+	return removed;
 }
 
 /**
- * Send a single signed 16-bit integer to the Arduino through the serial port.
- * Converts an int16_t to network byte order and sends it byte by byte through
- * the given serial port connection to the Arduino on the other end.  Network
- * byte order raw integers can be read by the Arduino using the corresponding
- * "read" function in the Arduino library, arduino_libuino.h .
- * @param cnx Pointer to ino_connection_t object through which to send data.
- * @param val int16_t to be sent to Arduino.
- * @return The number of bytes actually sent, or -1 on error.
- * @since 0.1
+ * Compare the watched directory against the devices known to be in it.
+ * Used for the first wait and when inotify dropped events.
+ * @param watcher Pointer to ino_watcher_t object.
+ * @return The number of reported devices removed, or -1 on error.
+ * @since 0.2
  */
-int
-ino_send_int16(ino_connection_t *cnx, int16_t val)
+static int
+ino_watcher_rescan(ino_watcher_t *watcher)
 {
-	int n = 0;
-	uint8_t buf[2];
-	ino_int16 i;
+	DIR *d;
+	struct dirent *e;
+	int i, events = 0;
 	
-	/* if connected */	
-	if ( cnx && cnx->fd > -1 )
+	d = opendir(watcher->dir);
+	if ( !d ) return -1;
+	
+	for(i=0; i<watcher->npresent; i++) watcher->present[i].seen = 0;
+	while ( ( e = readdir(d) ) )
+		events += ino_watcher_update(watcher, e->d_name, 0);
+	closedir(d);
+	
+	for(i=watcher->npresent-1; i>=0; i--)
 	{
-		i.sig = val;
-		buf[0] = (i.unsig >> 8) & 0xFF;
-		buf[1] = i.unsig & 0xFF;
-		n = write(cnx->fd, buf, 2);
+		if ( !watcher->present[i].seen )
+		{
+			events += ( watcher->present[i].state != INO_PRESENT_ADDED );
+			ino_watcher_remove(watcher, i);
+		}
 	}
 	
-	return n;
+	return events;
 }
 
 /**
- * Send a single unsigned 16-bit integer to the Arduino through the serial port.
- * Converts an uint16_t to network byte order and sends it byte by byte through
- * the given serial port connection to the Arduino on the other end.  Network
- * byte order raw integers can be read by the Arduino using the corresponding
- * "read" function in the Arduino library, arduino_libuino.h .
- * @param cnx Pointer to ino_connection_t object through which to send data.
- * @param val uint16_t to be sent to Arduino.
- * @return The number of bytes actually sent, or -1 on error.
- * @since 0.1
+ * Create a new watcher for serial devices coming and going in a directory.
+ * The directory is watched with inotify.  Attach connections with
+ * ino_watcher_attach() and call ino_watcher_wait() in a loop: whenever a
+ * device with an attached identity appears the connection is pointed at its
+ * node and opened, and whenever the node disappears the connection is
+ * closed, so a board that re-enumerates after a USB glitch is back as soon as
+ * its node is.  Boards that announce themselves with INO_CONNECT_HANDSHAKE
+ * come back fastest; several boards appearing together are opened together
+ * with ino_open_all().  The first ino_watcher_wait() reports the devices
+ * already present.  Must be freed with ino_watcher_destroy().
+ * @param dir Directory to watch, or NULL for /dev.
+ * @param cb Function called for each device added or removed, or NULL.
+ * @param arg User argument passed to cb.
+ * @return Pointer to new ino_watcher_t object, or NULL on error.
+ * @since 0.2
  */
-int
-ino_send_uint16(ino_connection_t *cnx, uint16_t val)
+ino_watcher_t *
+ino_watcher_new(const char *dir, ino_device_cb cb, void *arg)
 {
-	int n = 0;
-	uint8_t buf[2];
+	ino_watcher_t *watcher;
 	
-	/* if connected */	
-	if ( cnx && cnx->fd > -1 )
+	if ( !dir ) dir = "/dev";
+	if ( strlen(dir) >= INO_DEVICE_PATH_SIZE ) return NULL;
+	
+	watcher = (ino_watcher_t *)calloc(1, sizeof(ino_watcher_t));
+	if ( !watcher ) return NULL;
+	
+	strcpy(watcher->dir, dir);
+	watcher->cb = cb;
+	watcher->arg = arg;
+	watcher->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if ( watcher->fd == -1
+		|| inotify_add_watch(watcher->fd, dir, IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB | IN_ONLYDIR) == -1 )
 	{
-		buf[0] = (val >> 8) & 0xFF;
-		buf[1] = val & 0xFF;
-		n = write(cnx->fd, buf, 2);
+		if ( watcher->fd > -1 ) close(watcher->fd);
+		free(watcher);
+		return NULL;
 	}
 	
-	return n;
+	return watcher;
 }
 
 /**
- * Send a single signed 32-bit integer to the Arduino through the serial port.
- * Converts an int32_t to network byte order and sends it byte by byte through
- * the given serial port connection to the Arduino on the other end.  Network
- * byte order raw integers can be read by the Arduino using the corresponding
- * "read" function in the Arduino library, arduino_libuino.h .
- * @param cnx Pointer to ino_connection_t object through which to send data.
- * @param val int32_t to be sent to Arduino.
- * @return The number of bytes actually sent, or -1 on error.
- * @since 0.1
+ * Free a watcher created with ino_watcher_new().
+ * Attached connections are detached and left as they are; they must be
+ * destroyed separately.
+ * @param watcher Pointer to ino_watcher_t object to be destroyed.
+ * @since 0.2
+ */
+void
+ino_watcher_destroy(ino_watcher_t *watcher)
+{
+	if ( watcher )
+	{
+		while ( watcher->watches ) ino_watcher_detach(watcher, watcher->watches->cnx);
+		close(watcher->fd);
+		free(watcher->present);
+		free(watcher);
+	}
+}
+
+/**
+ * Attach a connection to the device with the given identity.
+ * The connection's port is managed by the watcher from then on.  If the
+ * device is already present the connection is opened straight away, so
+ * the device callback may create and attach a connection for a device it
+ * is told about.  A connection can only be attached to one identity.
+ * @param watcher Pointer to ino_watcher_t object.
+ * @param id Stable identity of the device, see ino_device_t.
+ * @param cnx Pointer to ino_connection_t object to attach.
+ * @return -1 on error, including failing to open a device that is present,
+ *         and zero on success.
+ * @since 0.2
  */
 int
-ino_send_int32(ino_connection_t *cnx, int32_t val)
+ino_watcher_attach(ino_watcher_t *watcher, const char *id, ino_connection_t *cnx)
 {
-	int n = 0;
-	uint8_t buf[4];
-	ino_int32 i;
+	struct _ino_watch_s *watch;
+	int i;
 	
-	/* if connected */	
-	if ( cnx && cnx->fd > -1 )
+	if ( !watcher || !id || !cnx || strlen(id) >= INO_DEVICE_ID_SIZE ) return -1;
+	for(watch=watcher->watches; watch; watch=watch->next)
+		if ( watch->cnx == cnx || strcmp(watch->id, id) == 0 ) return -1;
+	
+	watch = (struct _ino_watch_s *)calloc(1, sizeof(struct _ino_watch_s));
+	if ( !watch ) return -1;
+	watch->cnx = cnx;
+	watch->port = cnx->port;
+	strcpy(watch->id, id);
+	watch->next = watcher->watches;
+	watcher->watches = watch;
+	
+	/* open right away if the device is already here */
+	for(i=0; i<watcher->npresent; i++)
 	{
-		i.sig = val;
-		buf[0] = (i.unsig >> 24) & 0xFF;
-		buf[1] = (i.unsig >> 16) & 0xFF;
-		buf[2] = (i.unsig >> 8) & 0xFF;
-		buf[3] = i.unsig & 0xFF;
-		n = write(cnx->fd, buf, 4);
+		if ( strcmp(watcher->present[i].dev.id, id) == 0 )
+		{
+			strcpy(watch->path, watcher->present[i].dev.path);
+			cnx->port = watch->path;
+			if ( !ino_is_open(cnx) ) return ino_open(cnx);
+		}
 	}
-		
-	return n;
+	
+	return 0;
 }
 
 /**
- * Send a single unsigned 32-bit integer to the Arduino through the serial port.
- * Converts a uint32_t to network byte order and sends it byte by byte through
- * the given serial port connection to the Arduino on the other end.  Network
- * byte order raw integers can be read by the Arduino using the corresponding
- * "read" function in the Arduino library, arduino_libuino.h .
- * @param cnx Pointer to ino_connection_t object through which to send data.
- * @param val uint32_t to be sent to Arduino.
- * @return The number of bytes actually sent, or -1 on error.
- * @since 0.1
+ * Detach a connection from a watcher without closing it.
+ * The port the connection had before it was attached is restored.
+ * @param watcher Pointer to ino_watcher_t object.
+ * @param cnx Pointer to an attached ino_connection_t object.
+ * @return -1 on error and zero on success.
+ * @since 0.2
  */
 int
-ino_send_uint32(ino_connection_t *cnx, uint32_t val)
+ino_watcher_detach(ino_watcher_t *watcher, ino_connection_t *cnx)
 {
-	int n = 0;
-	uint8_t buf[4];
+	struct _ino_watch_s **link;
+	struct _ino_watch_s *watch;
 	
-	/* if connected */	
-	if ( cnx && cnx->fd > -1 )
+	if ( !watcher || !cnx ) return -1;
+	
+	for(link=&watcher->watches; *link; link=&(*link)->next)
 	{
-		buf[0] = (val >> 24) & 0xFF;
-		buf[1] = (val >> 16) & 0xFF;
-		buf[2] = (val >> 8) & 0xFF;
-		buf[3] = val & 0xFF;
-		n = write(cnx->fd, buf, 4);
+		if ( (*link)->cnx == cnx )
+		{
+			watch = *link;
+			*link = watch->next;
+			if ( cnx->port == watch->path ) cnx->port = watch->port;
+			free(watch);
+			return 0;
+		}
 	}
-		
-	return n;
+	
+	return -1;
 }
 
 /**
- * Send a single char through the serial port.
- * Sends a single character through the serial port to the Arduino.
- * @param c The character to send to the Arduino.
- * @return 1 on success, or -1 on failure.
- * @since 0.1
+ * Get the descriptor that becomes readable when the watched directory changes.
+ * Add it to an event loop, e.g. epoll, and call ino_watcher_wait() with a
+ * zero timeout when it is readable.
+ * @param watcher Pointer to ino_watcher_t object.
+ * @return The inotify descriptor, or -1 on error.
+ * @since 0.2
  */
-int ino_send_char(ino_connection_t *cnx, char c)
+int
+ino_watcher_fd(ino_watcher_t *watcher)
 {
- 	int n = -1;
- 	
-	/* if connected */	
-	if ( cnx && cnx->fd > -1 )
+	return watcher ? watcher->fd : -1;
+}
+
+/**
+ * Wait for devices to come and go and open or close their connections.
+ * Blocks up to timeout_ms milliseconds, or indefinitely if timeout_ms is -1,
+ * for the directory to change, then opens the attached connections of the
+ * devices that appeared and closes those of the devices that disappeared.
+ * The callback is invoked for each with INO_DEVICE_ADDED or
+ * INO_DEVICE_REMOVED and the attached connection, or NULL if none is.
+ * Connections reopened this way must be registered again with any poller
+ * or io_uring engine they were on.  A connection that fails to open is
+ * retried when its node's attributes change, e.g. when udev sets its
+ * permissions.
+ * @param watcher Pointer to ino_watcher_t object.
+ * @param timeout_ms Milliseconds to wait, 0 to return immediately, -1 forever.
+ * @return The number of devices added or removed, or -1 on error.
+ * @since 0.2
+ */
+int
+ino_watcher_wait(ino_watcher_t *watcher, int timeout_ms)
+{
+	/* inotify events are aligned for struct inotify_event */
+	char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	const struct inotify_event *ev;
+	struct _ino_watch_s *watch;
+	ino_connection_t **cnxs;
+	struct pollfd pfd;
+	ino_device_t dev;
+	int i, n, ncnxs, events = 0, rescan = 0;
+	
+	if ( !watcher ) return -1;
+	
+	if ( !watcher->scanned )
 	{
-		n = write(cnx->fd, &c, 1);
-		if ( n < 1 ) n = -1;
+		/* report what is already there */
+		watcher->scanned = 1;
+		rescan = 1;
+	}
+	else
+	{
+		pfd.fd = watcher->fd;
+		pfd.events = POLLIN;
+		do n = poll(&pfd, 1, timeout_ms); while ( n < 0 && errno == EINTR );
+		if ( n < 0 ) return -1;
 	}
 	
-	return n;
+	/* drain the events, every change is looked up afresh */
+	while ( ( n = read(watcher->fd, buf, sizeof(buf)) ) > 0 )
+	{
+		for(i=0; i<n; i+=sizeof(struct inotify_event) + ev->len)
+		{
+			ev = (const struct inotify_event *)( buf + i );
+			if ( ev->mask & IN_Q_OVERFLOW )
+				rescan = 1;
+			else if ( ev->len > 0 )
+				events += ino_watcher_update(watcher, ev->name, ev->mask);
+		}
+	}
+	if ( n < 0 && errno != EAGAIN && errno != EINTR ) return -1;
+	if ( rescan )
+	{
+		n = ino_watcher_rescan(watcher);
+		if ( n < 0 ) return -1;
+		events += n;
+	}
+	
+	/* open the connections of new devices together, boot waits overlap */
+	cnxs = (ino_connection_t **)malloc(( watcher->npresent ? watcher->npresent : 1 ) * sizeof(*cnxs));
+	if ( !cnxs ) return -1;
+	ncnxs = 0;
+	for(i=0; i<watcher->npresent; i++)
+	{
+		if ( watcher->present[i].state == INO_PRESENT_KNOWN ) continue;
+		watch = ino_watcher_lookup(watcher, watcher->present[i].dev.id);
+		if ( !watch || ino_is_open(watch->cnx) ) continue;
+		strcpy(watch->path, watcher->present[i].dev.path);
+		watch->cnx->port = watch->path;
+		cnxs[ncnxs++] = watch->cnx;
+	}
+	if ( ncnxs > 0 ) ino_open_all(cnxs, ncnxs, NULL);
+	free(cnxs);
+	
+	/* the callback may attach connections, which looks the devices up */
+	for(i=0; i<watcher->npresent; i++)
+	{
+		if ( watcher->present[i].state == INO_PRESENT_ADDED )
+		{
+			watcher->present[i].state = INO_PRESENT_KNOWN;
+			events++;
+			if ( watcher->cb )
+			{
+				dev = watcher->present[i].dev;
+				watch = ino_watcher_lookup(watcher, dev.id);
+				watcher->cb(&dev, watch ? watch->cnx : NULL, INO_DEVICE_ADDED, watcher->arg);
+			}
+		}
+		else
+			watcher->present[i].state = INO_PRESENT_KNOWN;
+	}
+	
+	return events;
 }
-
+#endif
@@ -36,17 +36,20 @@
  * values, then you may use the ino_cast_int(), ino_cast_long(),
  * ino_cast_float(), and ino_cast_double() functions to quickly
  * cast them to numeric types according to their position number.
- * Although if normally reading all numeric values in the order they
- * appear, you may find using the standard C functions strtol(),
- * strtof(), and strtod() slightly faster if that is important.
- * The ino_cast_*() functions are quite convenient though, especially
+ * When reading all numeric values in the order they appear, use
+ * ino_cast_ints(), ino_cast_longs(), ino_cast_floats(), or
+ * ino_cast_doubles() instead, which convert every field into an array
+ * in a single pass over the string.  ino_split() indexes the field
+ * offsets for random access without rescanning.
+ * The positional ino_cast_*() functions remain convenient, especially
  * for quickly grabbing a value at a specific position in the string
  * without having to count white-spaces.
  
  * In order to transfer raw, unprocessed bytes, you should use the
  * ino_connection_raw() function to create a ino_connection_t object.
- * The "raw" functions will send and receive 16-bit and 32-bit signed
- * or unsigned integers. All integers are converted to network byte
+ * The "raw" functions will send and receive 16, 32 and 64-bit signed
+ * or unsigned integers as well as IEEE-754 floats and doubles in
+ * binary form. All values are converted to network byte
  * order (i.e., big endian) for sending and then back into host byte
  * order when receiving integer data. To use the raw data functions
  * in the library, more than likely you will also want to include
@@ -66,12 +69,55 @@
 #include <fcntl.h>
 #include <termios.h>
 #include <errno.h>
+#include <limits.h>
+#include <float.h>
+#include <locale.h>
+#include <poll.h>
+#include <time.h>
+#include <pthread.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /* CONSTANTS */
 #define INO_DEFAULT_WAIT 3500000
 #define INO_NO_WAIT 0
 #define INO_NO_TIMEOUT 0
+#define INO_INPUT_BUFFER_SIZE 4096
+#define INO_MAX_LINE_SIZE 1048576
+#define INO_OUTPUT_BUFFER_SIZE 4096
+#define INO_POLLER_MAX_EVENTS 64
+#define INO_CACHE_LINE 64
+#define INO_PARSE_OK 0
+#define INO_PARSE_INVALID -1
+#define INO_PARSE_RANGE -2
+#define INO_MAX_FRAME_SIZE 65535
+#define INO_FRAME_END 0xC0
+#define INO_FRAME_ESC 0xDB
+#define INO_FRAME_ESC_END 0xDC
+#define INO_FRAME_ESC_ESC 0xDD
+#define INO_CRC16_INIT 0xFFFF
+#define INO_CRC32C_INIT 0
+#define INO_BAUD_TOLERANCE 2
+#define INO_READY_BYTE 0x06
+#define INO_CONNECT_WAIT 0
+#define INO_CONNECT_HANDSHAKE 1
+#define INO_CONNECT_NO_RESET 2
+#define INO_DEVICE_PATH_SIZE 256
+#define INO_DEVICE_ID_SIZE 128
+#define INO_DEVICE_SERIAL_SIZE 64
+#define INO_DEVICE_ADDED 1
+#define INO_DEVICE_REMOVED 2
+#define INO_TUNED_ASYNC_LOW_LATENCY 1
+#define INO_TUNED_LATENCY_TIMER 2
+#define INO_LATENCY_TIMER_MS 1
+#define INO_PACKED_SIZE(count, bits) ( ( (long)(count) * (bits) + 7 ) / 8 )
 
 /**
  * Data type for converting between signed and unsigned 16-bit integers and byte arrays.
@@ -97,6 +143,106 @@ typedef union _ino_int32
 }
 ino_int32;
 
+/**
+ * Data type for converting between signed and unsigned 64-bit integers and byte arrays.
+ * @since 0.2
+ */
+typedef union _ino_int64
+{
+	int64_t sig;						/**< signed integer */
+	uint64_t unsig;					/**< unsigned integer */
+	unsigned char bytes[8];	/**< byte array */
+}
+ino_int64;
+
+/**
+ * Data type for converting between single precision floats and their IEEE-754 binary32 bits.
+ * @since 0.2
+ */
+typedef union _ino_float32
+{
+	float val;							/**< floating point value */
+	uint32_t bits;					/**< binary32 encoding */
+	unsigned char bytes[4];	/**< byte array */
+}
+ino_float32;
+
+/**
+ * Data type for converting between double precision floats and their IEEE-754 binary64 bits.
+ * @since 0.2
+ */
+typedef union _ino_float64
+{
+	double val;							/**< floating point value */
+	uint64_t bits;					/**< binary64 encoding */
+	unsigned char bytes[8];	/**< byte array */
+}
+ino_float64;
+
+/**
+ * Data type for a read-only view of a frame inside a connection's input buffer.
+ * @since 0.2
+ */
+typedef struct _ino_frame_view_s
+{
+	const uint8_t *data;	/**< first byte of the frame; NULL if nothing was read */
+	int size;						/**< number of bytes in the frame */
+}
+ino_frame_view_t;
+
+/**
+ * Data type for one line of text returned by ino_read_lines().
+ * @since 0.2
+ */
+typedef struct _ino_line_s
+{
+	char *text;					/**< zero terminated line without its line ending */
+	int size;						/**< number of characters in text */
+}
+ino_line_t;
+
+/**
+ * Data type for a background reader's lock-free single-producer/single-consumer frame queue.
+ * The reader thread is the only writer of tail, partial, skip and dropped; the
+ * application is the only writer of head.  The two sides live on separate
+ * cache lines so neither invalidates the other's line on every frame.
+ * @since 0.2
+ */
+typedef struct _ino_reader_s
+{
+	uint8_t *frames;		/**< storage for capacity frames of frame_size bytes each */
+	size_t mask;				/**< capacity - 1, capacity being a power of two */
+	int frame_size;			/**< number of bytes in each frame */
+	int wake[2];				/**< pipe used to wake the reader thread for shutdown */
+	pthread_t thread;		/**< reader thread */
+	size_t tail __attribute__((aligned(INO_CACHE_LINE)));	/**< frames published by the reader thread */
+	size_t head_cache;	/**< reader thread's last view of head */
+	int partial;				/**< bytes of the frame in progress */
+	int skip;						/**< bytes left of a frame being discarded */
+	int running;				/**< 1 until the reader thread exits on shutdown, hang up or error */
+	unsigned long dropped;	/**< frames discarded because the queue was full */
+	size_t head __attribute__((aligned(INO_CACHE_LINE)));	/**< frames popped by the application */
+	size_t tail_cache;	/**< application's last view of tail */
+}
+ino_reader_t;
+
+/**
+ * Opaque per-connection state of a connection attached to an ino_uring_t.
+ * @since 0.2
+ */
+struct _ino_uring_slot_s;
+
+struct _ino_connection_s;
+
+/**
+ * Callback type for frames dispatched by an ino_poller_t.
+ * Called with a pointer to each complete frame inside the connection's input
+ * buffer.  The frame is only valid until the callback returns.  Called once
+ * with a NULL frame and frame_size_bytes of -1 when the port hangs up or fails.
+ * @since 0.2
+ */
+typedef void (*ino_frame_cb)(struct _ino_connection_s *cnx, const uint8_t *frame, int frame_size_bytes, void *arg);
+
 /**
  * Data type for storing an Arduino connection's settings.
  * @since 0.1
@@ -105,6 +251,16 @@ typedef struct _ino_connection_s
 {
 	char *port;					/**< tty(COM) port */
 	speed_t baud;				/**< bit rate */
+	int baud_rate;			/**< integer bit rate set with ino_set_baud_rate(), overrides baud.
+											   0 = use baud. */
+	int connect_mode;		/**< how ino_open() waits for the arduino, see ino_set_connect_mode().
+											   INO_CONNECT_WAIT = sleep connect_wait microseconds.
+											   INO_CONNECT_HANDSHAKE = wait at most connect_wait for the ready byte.
+											   INO_CONNECT_NO_RESET = do not reset the arduino or wait at all. */
+	int low_latency;		/**< whether ino_open() tunes the driver for latency, see ino_set_low_latency().
+											   0 = leave the driver as it is.
+											   1 = set ASYNC_LOW_LATENCY and lower the latency timer. */
+	int latency_tunings;	/**< INO_TUNED_ flags in effect since the connection was last opened */
 	int connect_wait;		/**< length of time in microseconds to wait for arduino to reboot
 											   on connection. set to zero if arduino model does not reboot
 											   automatically on each connection or if autoreboot is disabled. */
@@ -119,9 +275,91 @@ typedef struct _ino_connection_s
 											   0 = never timeout, wait until enough bytes are read.
 											   ignored unless raw is set to 1 (TRUE) */
 	int fd;							/**< open port; -1 if closed or on error */
+	uint8_t *in_buf;		/**< input buffer filled by large opportunistic reads of the port.
+											   all raw read functions consume their bytes from here. */
+	int in_size;				/**< capacity of in_buf in bytes */
+	int in_head;				/**< offset of the first unread byte in in_buf */
+	int in_tail;				/**< offset one past the last unread byte in in_buf */
+	int view_size;			/**< bytes of the frame view handed out by ino_read_view(), consumed
+											   at the next read or ino_release_view() */
+	int exact;					/**< whether raw reads wait for the exact number of bytes requested.
+											   0 = a read returns whatever the port delivers (VMIN/VTIME).
+											   1 = a read polls until every byte arrives or exact_timeout expires. */
+	long exact_timeout;	/**< microseconds allowed for each exact read.
+											   INO_NO_TIMEOUT = wait until all bytes arrive.
+											   ignored unless exact is set to 1. */
+	int nonblock;				/**< 1 while the open port is in non-blocking mode */
+	int lines;					/**< whether a processed connection splits lines itself.
+											   0 = canonical mode, the kernel assembles each line.
+											   1 = the port is read raw in large chunks and lines are
+											   split in the input buffer. ignored if raw is set to 1. */
+	ino_frame_cb frame_cb;	/**< callback for frames dispatched by an ino_poller_t; NULL if not registered */
+	void *frame_arg;		/**< user argument passed to frame_cb */
+	ino_reader_t *reader;	/**< background reader; NULL unless started with ino_reader_start() */
+	struct _ino_uring_slot_s *uring;	/**< io_uring attachment; NULL when using read()/write() */
+	uint8_t *out_buf;		/**< transmit buffer holding corked output; NULL until ino_cork() */
+	int out_size;				/**< capacity of out_buf in bytes */
+	int out_len;				/**< bytes waiting in out_buf */
+	int corked;					/**< 1 while ino_send_*() output is held in out_buf until flushed */
+	int flush_threshold;	/**< corked output is flushed once this many bytes are waiting.
+											   0 = only when out_buf is full. */
+	long flush_delay;		/**< corked output is flushed by the first send this many microseconds
+											   after the oldest waiting byte was corked. 0 = no deadline. */
+	struct timespec out_since;	/**< when the oldest waiting byte was corked */
+	uint8_t *scratch;		/**< reusable buffer for encoding whole arrays; NULL until needed */
+	int scratch_size;		/**< capacity of scratch in bytes */
+	unsigned long frame_errors;	/**< frames dropped by ino_read_frame() for a bad escape, length or CRC */
 }
 ino_connection_t;
 
+#ifdef __linux__
+/**
+ * Data type for an epoll reactor servicing many Arduino connections at once.
+ * @since 0.2
+ */
+typedef struct _ino_poller_s
+{
+	int epfd;						/**< epoll instance; -1 on error */
+	struct epoll_event events[INO_POLLER_MAX_EVENTS];	/**< ready list filled by epoll_wait() */
+}
+ino_poller_t;
+
+/**
+ * Opaque data type for an io_uring I/O engine driving many Arduino connections.
+ * @since 0.2
+ */
+typedef struct _ino_uring_s ino_uring_t;
+
+/**
+ * Data type describing a serial device found by ino_discover() or an ino_watcher_t.
+ * @since 0.2
+ */
+typedef struct _ino_device_s
+{
+	char path[INO_DEVICE_PATH_SIZE];	/**< device node to open, e.g. /dev/ttyACM0 */
+	char id[INO_DEVICE_ID_SIZE];			/**< stable identity, the same after the board is replugged.
+																		   USB devices: vid:pid:serial in hex, e.g. 2341:0043:8573532383035171E0A1,
+																		   with the USB port path, e.g. 1-1.2, standing in for a missing serial.
+																		   other devices: the name of the node, e.g. ttyAMA0. */
+	int vid;													/**< USB vendor id; -1 if not a USB device */
+	int pid;													/**< USB product id; -1 if not a USB device */
+	char serial[INO_DEVICE_SERIAL_SIZE];	/**< USB serial number; empty if none */
+}
+ino_device_t;
+
+/**
+ * Opaque data type for a watcher that attaches connections to devices as they are plugged in.
+ * @since 0.2
+ */
+typedef struct _ino_watcher_s ino_watcher_t;
+
+/**
+ * Function called by ino_watcher_wait() for each device added or removed.
+ * @since 0.2
+ */
+typedef void (*ino_device_cb)(const ino_device_t *dev, ino_connection_t *cnx, int event, void *arg);
+#endif
+
 /**
  * Create a new character-oriented Arduino connection configuration object.
  * Use this function to configure a connection for transfering character data
@@ -177,7 +415,9 @@ ino_connection_t *ino_connection_raw(char *port, speed_t baud, int connect_wait,
  * Close Arduino connection and free config object from memory. 
  * Use this function when the connection is no longer needed.  To merely
  * close the connection and retain it to be opened again later, use the
- * ino_close() function instead.
+ * ino_close() function instead.  Frame callbacks may destroy any connection,
+ * including their own; the memory of their own connection is freed once the
+ * callback returns.
  * @param cnx Pointer to ino_connection_t object to be destroyed.
  * @since 0.1
  */
@@ -193,6 +433,26 @@ void ino_connection_destroy(ino_connection_t *cnx);
  */
 int ino_open(ino_connection_t *cnx);
 
+/**
+ * Open many configured serial ports to Arduinos at once.
+ * Opening each connection with ino_open() in turn costs one reboot wait per
+ * board.  This function opens every port first, so all the boards reset
+ * together, and then waits for all of them at the same time: connections in
+ * INO_CONNECT_WAIT mode are configured as their connect_wait runs out,
+ * connections in INO_CONNECT_HANDSHAKE mode are polled together for their
+ * ready bytes, and connections in INO_CONNECT_NO_RESET mode are configured
+ * right away.  Opening a fleet of boards takes about as long as the slowest
+ * board.  Connections that are already open are closed and reopened.
+ * @param cnxs Array of pointers to ino_connection_t objects to open.
+ * @param count Number of connections in cnxs.
+ * @param status Array of count ints filled with zero for each connection
+ *        opened and the errno value for each connection that failed, e.g.
+ *        ETIMEDOUT if a board did not report ready in time; may be NULL.
+ * @return The number of connections opened, or -1 on error.
+ * @since 0.2
+ */
+int ino_open_all(ino_connection_t **cnxs, int count, int *status);
+
 /**
  * Close Arduino connection, but retain the ino_connection_t configuration. 
  * Use this function to close the Arduino connection port temporarily.
@@ -215,11 +475,97 @@ int ino_close(ino_connection_t *cnx);
  */
 int ino_is_open(ino_connection_t *cnx);
 
+/**
+ * Choose how ino_open() waits for the Arduino to come up.
+ * Opening the port raises DTR, which resets most Arduinos, so by default
+ * (INO_CONNECT_WAIT) ino_open() sleeps connect_wait microseconds, e.g. the
+ * 3.5 s of INO_DEFAULT_WAIT, before it configures the port.
+ *
+ * INO_CONNECT_HANDSHAKE instead configures the port right away and waits for
+ * the INO_READY_BYTE that the sketch sends with ino_send_ready() from the
+ * Arduino library at the end of setup().  ino_open() returns as soon as it
+ * arrives, typically well under a second after the reset, and fails with
+ * errno set to ETIMEDOUT if it does not arrive within connect_wait.
+ *
+ * INO_CONNECT_NO_RESET is for boards that are already running.  The port is
+ * configured without waiting, HUPCL is cleared so DTR stays raised when the
+ * port is closed, and DTR is held raised.  Boards whose DTR was left raised
+ * this way are not reset by later opens.  The very first open after the port
+ * was closed with HUPCL set still resets the board, as the kernel raises DTR
+ * during open() itself.  No handshake takes place in this mode.
+ * @param cnx Pointer to ino_connection_t object to configure.
+ * @param mode INO_CONNECT_WAIT, INO_CONNECT_HANDSHAKE or INO_CONNECT_NO_RESET.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int ino_set_connect_mode(ino_connection_t *cnx, int mode);
+
+/**
+ * Use an integer bit rate instead of one of the termios B constants.
+ * The B constants stop at rates such as B115200 on many systems and have no
+ * code at all for the 250000, 500000 or 2000000 bit/s that ATmega16U2 and
+ * CH340 bridges run reliably at, which divide the AVR's 16 MHz clock exactly.
+ * On Linux the rate is set with the termios2 ioctls and BOTHER, elsewhere
+ * with cfsetispeed()/cfsetospeed().  The rate the driver actually applied is
+ * read back, and the call fails if it is more than INO_BAUD_TOLERANCE percent
+ * off, as the UARTs on both ends would then lose bytes.  The setting may be
+ * changed before or after the connection is opened; the baud passed to
+ * ino_connection_new() or ino_connection_raw() is ignored from then on.  If
+ * the rate is rejected, an open port keeps its settings and the connection
+ * its previous rate.
+ * @param cnx Pointer to ino_connection_t object to configure.
+ * @param rate Bit rate, e.g. 250000, 500000, 1000000 or 2000000.
+ * @return The bit rate the driver applied, rate itself if not open yet, or -1
+ *         on error or if the driver cannot get close enough to rate.
+ * @since 0.2
+ */
+int ino_set_baud_rate(ino_connection_t *cnx, int rate);
+
+/**
+ * Get the bit rate an open connection is running at, as reported by the driver.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @return Bit rate, or -1 on error.
+ * @since 0.2
+ */
+int ino_get_baud_rate(ino_connection_t *cnx);
+
+/**
+ * Tune the serial driver for latency rather than throughput.
+ * USB-serial bridges hold incoming bytes back to fill USB packets: FTDI
+ * chips wait up to their 16 ms latency timer, and the kernel may defer
+ * handing bytes to readers unless ASYNC_LOW_LATENCY is set.  With low latency
+ * on, ino_open() sets ASYNC_LOW_LATENCY with TIOCSSERIAL and lowers the
+ * latency_timer in sysfs to INO_LATENCY_TIMER_MS where the driver has one,
+ * which usually requires write access to sysfs.  Tunings the port does not
+ * support, e.g. on ptys or CDC-ACM boards, are skipped without failing; use
+ * ino_get_latency_tunings() to see which took effect.  The tunings belong to
+ * the device rather than the connection, so they outlast ino_close() until
+ * the device is replugged.  Exact reads, see ino_set_read_exact(), also
+ * avoid the VTIME granularity of 0.1 s.
+ * @param cnx Pointer to ino_connection_t object to configure.
+ * @param low_latency 1 to tune the driver when opening, 0 to leave it alone.
+ * @return The INO_TUNED_ flags in effect if the connection is open, zero if
+ *         not, or -1 on error.
+ * @since 0.2
+ */
+int ino_set_low_latency(ino_connection_t *cnx, int low_latency);
+
+/**
+ * Get the latency tunings in effect on an open connection.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @return INO_TUNED_ASYNC_LOW_LATENCY and INO_TUNED_LATENCY_TIMER or'ed
+ *         together, zero if none, or -1 on error.
+ * @since 0.2
+ */
+int ino_get_latency_tunings(ino_connection_t *cnx);
+
 /**
  * Read a string from the Arduino.
  * Read processed, canonical, string-oriented i/o, terminated by new line character.
  * The connection must be created using the ino_connection_new() function and
- * opened using ino_open().
+ * opened using ino_open().  In line mode (see ino_set_line_mode()) one line,
+ * including its new line character, is copied from the input buffer; a line
+ * longer than max_bytes - 1 is returned in pieces as in canonical mode.
  * @param cnx Pointer to ino_connection_t object from which to be read.
  * @param buf String buffer into which to read the string from the Arduino.
  * @param max_bytes Maximum number of bytes to read, e.g., size of buffer.
@@ -228,6 +574,43 @@ int ino_is_open(ino_connection_t *cnx);
  */
 int ino_read(ino_connection_t *cnx, char *buf, int max_bytes);
 
+/**
+ * Switch a processed connection to or from user-space line splitting.
+ * By default the tty is put in canonical mode and the kernel line discipline
+ * handles every byte, delivers at most one line per read() and truncates
+ * lines at 4095 characters.  In line mode the port is read raw in chunks as
+ * large as the input buffer and lines are found with memchr(), so a chatty
+ * board costs a fraction of the system calls.  Lines of any length up to
+ * INO_MAX_LINE_SIZE are supported.  The setting may be changed before or
+ * after the connection is opened.
+ * @param cnx Pointer to a processed ino_connection_t object to configure.
+ * @param lines 1 to split lines in user space, 0 to restore canonical mode.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int ino_set_line_mode(ino_connection_t *cnx, int lines);
+
+/**
+ * Read every complete line the Arduino has sent, up to max_lines.
+ * Waits at most timeout_us microseconds for the first line, then returns it
+ * together with all further complete lines already received, without copying
+ * them.  The new line character and a carriage return before it are replaced
+ * by a terminating zero, so each text can be handed straight to ino_cast_int()
+ * and friends.  The texts point into the connection's input buffer and stay
+ * valid until the next read function is called on the connection,
+ * ino_release_view() is called, or the connection is closed.  A partial line
+ * at the end of the input is kept for the next call.  A line that reaches
+ * INO_MAX_LINE_SIZE characters without a new line is returned as it is.
+ * Requires line mode, see ino_set_line_mode().
+ * @param cnx Pointer to ino_connection_t object from which to read lines.
+ * @param lines Array of at least max_lines ino_line_t to fill.
+ * @param max_lines Maximum number of lines to return.
+ * @param timeout_us Microseconds to wait for the first line, or INO_NO_TIMEOUT.
+ * @return Number of lines read, 0 on timeout or hang up, or -1 on error.
+ * @since 0.2
+ */
+int ino_read_lines(ino_connection_t *cnx, ino_line_t *lines, int max_lines, long timeout_us);
+
 /**
  * Cast white-space delimited string data to int by position in the string.
  * Extract numeric value at position, "pos," in the string.  E.g., in order
@@ -276,6 +659,127 @@ float ino_cast_float(char *frame, int pos);
  */
 double ino_cast_double(char *frame, int pos);
 
+/**
+ * Parse a decimal int from a string without depending on the locale.
+ * Works like ino_parse_long() with the value clamped to the range of int.
+ * @param str The string to parse.
+ * @param last End of the input, or NULL if str is zero terminated.
+ * @param val Filled with the value, clamped to INT_MIN or INT_MAX on overflow.
+ * @param status If not NULL, filled with INO_PARSE_OK, INO_PARSE_INVALID if
+ * there is no number, or INO_PARSE_RANGE on overflow.
+ * @return Position after the number, or str if there is no number.
+ * @since 0.2
+ */
+const char *ino_parse_int(const char *str, const char *last, int *val, int *status);
+
+/**
+ * Parse a decimal long from a string without depending on the locale.
+ * Accepts optional leading white-space and sign, like strtol() in base 10,
+ * but converts eight digits at a time.
+ * @param str The string to parse.
+ * @param last End of the input, or NULL if str is zero terminated.
+ * @param val Filled with the value, clamped to LONG_MIN or LONG_MAX on overflow.
+ * @param status If not NULL, filled with INO_PARSE_OK, INO_PARSE_INVALID if
+ * there is no number, or INO_PARSE_RANGE on overflow.
+ * @return Position after the number, or str if there is no number.
+ * @since 0.2
+ */
+const char *ino_parse_long(const char *str, const char *last, long *val, int *status);
+
+/**
+ * Parse a float from a string without depending on the locale.
+ * Accepts the same syntax as strtof() in the "C" locale and is correctly
+ * rounded.  Short decimal numbers take a fast path that avoids strtof().
+ * @param str The string to parse.
+ * @param last End of the input, or NULL if str is zero terminated.
+ * @param val Filled with the value.
+ * @param status If not NULL, filled with INO_PARSE_OK, INO_PARSE_INVALID if
+ * there is no number, or INO_PARSE_RANGE on overflow or underflow.
+ * @return Position after the number, or str if there is no number.
+ * @since 0.2
+ */
+const char *ino_parse_float(const char *str, const char *last, float *val, int *status);
+
+/**
+ * Parse a double from a string without depending on the locale.
+ * Accepts the same syntax as strtod() in the "C" locale and is correctly
+ * rounded.  Short decimal numbers take a fast path that avoids strtod().
+ * @param str The string to parse.
+ * @param last End of the input, or NULL if str is zero terminated.
+ * @param val Filled with the value.
+ * @param status If not NULL, filled with INO_PARSE_OK, INO_PARSE_INVALID if
+ * there is no number, or INO_PARSE_RANGE on overflow or underflow.
+ * @return Position after the number, or str if there is no number.
+ * @since 0.2
+ */
+const char *ino_parse_double(const char *str, const char *last, double *val, int *status);
+
+/**
+ * Index the fields of a delimited string in one pass.
+ * Records the offset of the first character of each field so any field can
+ * be converted later without rescanning the frame, e.g. with
+ * ino_parse_double(frame + offsets[i], NULL, &val, &status).  Fields are
+ * separated by runs of the same delimiters the ino_cast_*() functions use.
+ * @param frame Zero terminated frame of characters returned by ino_read().
+ * @param offsets Array filled with the byte offset of each field.
+ * @param max_fields Length of the offsets array.
+ * @return The number of fields indexed.
+ * @since 0.2
+ */
+int ino_split(const char *frame, int *offsets, int max_fields);
+
+/**
+ * Cast every field of a delimited string to int in one pass.
+ * Converts the fields in order into buf, scanning the frame only once, which
+ * is much faster than calling ino_cast_int() for each position.  Fields
+ * that are not numeric are stored as zero.
+ * @param frame Zero terminated frame of characters returned by ino_read().
+ * @param buf Array of int to receive the values.
+ * @param max_count Length of buf.
+ * @return The number of values stored in buf.
+ * @since 0.2
+ */
+int ino_cast_ints(const char *frame, int *buf, int max_count);
+
+/**
+ * Cast every field of a delimited string to long in one pass.
+ * Converts the fields in order into buf, scanning the frame only once, which
+ * is much faster than calling ino_cast_long() for each position.  Fields
+ * that are not numeric are stored as zero.
+ * @param frame Zero terminated frame of characters returned by ino_read().
+ * @param buf Array of long to receive the values.
+ * @param max_count Length of buf.
+ * @return The number of values stored in buf.
+ * @since 0.2
+ */
+int ino_cast_longs(const char *frame, long *buf, int max_count);
+
+/**
+ * Cast every field of a delimited string to float in one pass.
+ * Converts the fields in order into buf, scanning the frame only once, which
+ * is much faster than calling ino_cast_float() for each position.  Fields
+ * that are not numeric are stored as zero.
+ * @param frame Zero terminated frame of characters returned by ino_read().
+ * @param buf Array of float to receive the values.
+ * @param max_count Length of buf.
+ * @return The number of values stored in buf.
+ * @since 0.2
+ */
+int ino_cast_floats(const char *frame, float *buf, int max_count);
+
+/**
+ * Cast every field of a delimited string to double in one pass.
+ * Converts the fields in order into buf, scanning the frame only once, which
+ * is much faster than calling ino_cast_double() for each position.  Fields
+ * that are not numeric are stored as zero.
+ * @param frame Zero terminated frame of characters returned by ino_read().
+ * @param buf Array of double to receive the values.
+ * @param max_count Length of buf.
+ * @return The number of values stored in buf.
+ * @since 0.2
+ */
+int ino_cast_doubles(const char *frame, double *buf, int max_count);
+
 /* read raw, non-canonical byte i/o, exact number of bytes known to each end */
 /**
  * Read raw bytes from a raw Arduino serial connection.
@@ -291,6 +795,67 @@ double ino_cast_double(char *frame, int pos);
  */
 int ino_read_raw(ino_connection_t *cnx, uint8_t *buf, int frame_size_bytes);
 
+/**
+ * Read a frame of raw bytes without copying it.
+ * Works like ino_read_raw(), but instead of copying the bytes into a caller
+ * supplied array it points view at the frame in place inside the connection's
+ * input buffer.  The view is read-only and stays valid until the next read
+ * function is called on the connection, ino_release_view() is called, or the
+ * connection is closed.  Use it to inspect a few fields or to forward the
+ * bytes elsewhere without paying for copies.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param view Pointer to ino_frame_view_t to point at the frame.
+ * @param frame_size_bytes The exact number of bytes to read.
+ * @return The number of bytes in the view, or -1 on error.
+ * @since 0.2
+ */
+int ino_read_view(ino_connection_t *cnx, ino_frame_view_t *view, int frame_size_bytes);
+
+/**
+ * Release the frame view handed out by the last ino_read_view() call.
+ * The view's bytes are consumed and the view must no longer be used.  This
+ * happens implicitly on the next read, so calling it is only needed to
+ * release the buffer space early.
+ * @param cnx Pointer to ino_connection_t object that handed out the view.
+ * @since 0.2
+ */
+void ino_release_view(ino_connection_t *cnx);
+
+/**
+ * Switch a raw connection to or from exact-length reads.
+ * In exact mode every raw read function, including the typed integer readers,
+ * loops with poll() until all of its bytes have arrived or the timeout expires,
+ * instead of returning whatever a single read() yields.  Frames of any size,
+ * including those over the 255 byte VMIN limit of termios, are assembled
+ * reliably this way.  The timeout is in microseconds and covers each read
+ * call as a whole; use INO_NO_TIMEOUT to wait indefinitely.  The setting may
+ * be changed before or after the connection is opened.
+ * @param cnx Pointer to ino_connection_t object to configure.
+ * @param exact 1 to enable exact-length reads, 0 to restore VMIN/VTIME reads.
+ * @param timeout_us Microseconds to wait for a complete read, or INO_NO_TIMEOUT.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int ino_set_read_exact(ino_connection_t *cnx, int exact, long timeout_us);
+
+/**
+ * Read an exact number of raw bytes, waiting at most the given deadline.
+ * Loops with poll() and read() until frame_size_bytes bytes have arrived or
+ * timeout_us microseconds have elapsed, whichever comes first, regardless of
+ * whether the connection is in exact mode.  A return value smaller than
+ * frame_size_bytes means the deadline expired or the port hung up with only
+ * that many bytes delivered; those bytes are still stored in buf.  Outside
+ * exact mode the port only reports readiness once VMIN bytes are waiting, so
+ * enable exact mode with ino_set_read_exact() to read partial frames.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param buf Pointer to the beginning of an array of uint8_t.
+ * @param frame_size_bytes The exact number of bytes to read.
+ * @param timeout_us Microseconds to wait for all bytes, or INO_NO_TIMEOUT.
+ * @return The number of bytes read, or -1 on error.
+ * @since 0.2
+ */
+int ino_read_exact(ino_connection_t *cnx, uint8_t *buf, int frame_size_bytes, long timeout_us);
+
 /**
  * Read a single signed 16-bit integer from the given Arduino raw connection.
  * Reads 2 bytes from the serial port and converts them from network byte order
@@ -325,6 +890,8 @@ uint16_t ino_read_uint16(ino_connection_t *cnx);
  * byte in network byte order.  The function requires an ino_connection_t object
  * created using ino_connection_raw() with a 2 bytes per integer frame size,
  * i.e., three 2-byte integers would require a connection frame size of 6 bytes.
+ * The bytes are received directly into int_buf and converted in place, so
+ * arrays of any size are read without extra copies or allocation.
  * @param cnx Pointer to ino_connection_t object from which to read data.
  * @param int_buf Pointer to the beginning of an array of int16_t.
  * @param int_count The number of integers to attempt reading <= array length.
@@ -341,6 +908,8 @@ int ino_read_int16s(ino_connection_t *cnx, int16_t *int_buf, int int_count);
  * byte in network byte order.  The function requires an ino_connection_t object
  * created using ino_connection_raw() with a 2 bytes per integer frame size,
  * i.e., three 2-byte integers would require a connection frame size of 6 bytes.
+ * The bytes are received directly into int_buf and converted in place, so
+ * arrays of any size are read without extra copies or allocation.
  * @param cnx Pointer to ino_connection_t object from which to read data.
  * @param int_buf Pointer to the beginning of an array of uint16_t.
  * @param int_count The number of integers to attempt reading <= array length.
@@ -383,6 +952,8 @@ uint32_t ino_read_uint32(ino_connection_t *cnx);
  * byte in network byte order.  The function requires an ino_connection_t object
  * created using ino_connection_raw() with a 4 bytes per integer frame size,
  * i.e., three 4-byte integers would require a connection frame size of 12 bytes.
+ * The bytes are received directly into int_buf and converted in place, so
+ * arrays of any size are read without extra copies or allocation.
  * @param cnx Pointer to ino_connection_t object from which to read data.
  * @param int_buf Pointer to the beginning of an array of int32_t.
  * @param int_count The number of integers to attempt reading <= array length.
@@ -399,6 +970,8 @@ int ino_read_int32s(ino_connection_t *cnx, int32_t *int_buf, int int_count);
  * byte in network byte order.  The function requires an ino_connection_t object
  * created using ino_connection_raw() with a 4 bytes per integer frame size,
  * i.e., three 4-byte integers would require a connection frame size of 12 bytes.
+ * The bytes are received directly into int_buf and converted in place, so
+ * arrays of any size are read without extra copies or allocation.
  * @param cnx Pointer to ino_connection_t object from which to read data.
  * @param int_buf Pointer to the beginning of an array of uint32_t.
  * @param int_count The number of integers to attempt reading <= array length.
@@ -407,6 +980,270 @@ int ino_read_int32s(ino_connection_t *cnx, int32_t *int_buf, int int_count);
  */
 int ino_read_uint32s(ino_connection_t *cnx, uint32_t *int_buf, int int_count);
 
+/**
+ * Read a single signed 64-bit integer from the given Arduino raw connection.
+ * Reads 8 bytes from the serial port and converts them from network byte order
+ * into host byte order and casts them to a signed 64-bit integer.  The 
+ * corresponding Arduino library "send" function will send the integer byte by
+ * byte in network byte order.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with an 8 byte frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @return The int64_t read from the serial port.
+ * @since 0.2
+ */
+int64_t ino_read_int64(ino_connection_t *cnx);
+
+/**
+ * Read a single unsigned 64-bit integer from the given Arduino raw connection.
+ * Reads 8 bytes from the serial port and converts them from network byte order
+ * into host byte order and casts them to an unsigned 64-bit integer.  The 
+ * corresponding Arduino library "send" function will send the integer byte by
+ * byte in network byte order.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with an 8 byte frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @return The uint64_t read from the serial port.
+ * @since 0.2
+ */
+uint64_t ino_read_uint64(ino_connection_t *cnx);
+
+/**
+ * Read a single IEEE-754 single precision float from the given Arduino raw connection.
+ * Reads the 4 byte binary32 encoding in network byte order, so no text
+ * conversion is needed.  The corresponding Arduino library "send" function
+ * sends the value in that format.  The function requires an ino_connection_t
+ * object created using ino_connection_raw() with a 4 byte frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @return The float read from the serial port.
+ * @since 0.2
+ */
+float ino_read_float(ino_connection_t *cnx);
+
+/**
+ * Read a single IEEE-754 double precision float from the given Arduino raw connection.
+ * Reads the 8 byte binary64 encoding in network byte order, so no text
+ * conversion is needed.  The corresponding Arduino library "send" function
+ * sends the value in that format.  The function requires an ino_connection_t
+ * object created using ino_connection_raw() with an 8 byte frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @return The double read from the serial port.
+ * @since 0.2
+ */
+double ino_read_double(ino_connection_t *cnx);
+
+/**
+ * Read multiple signed 64-bit integers from an Arduino raw connection at once.
+ * Reads 8 bytes per value from the serial port and converts them from network
+ * byte order into host byte order.  The bytes are received directly into
+ * int_buf and converted in place, so arrays of any size are read without extra
+ * copies or allocation.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 8 bytes per value frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param int_buf Pointer to the beginning of an array of int64_t.
+ * @param int_count The number of values to attempt reading <= array length.
+ * @return The number of values read from the serial port.
+ * @since 0.2
+ */
+int ino_read_int64s(ino_connection_t *cnx, int64_t *int_buf, int int_count);
+
+/**
+ * Read multiple unsigned 64-bit integers from an Arduino raw connection at once.
+ * Reads 8 bytes per value from the serial port and converts them from network
+ * byte order into host byte order.  The bytes are received directly into
+ * int_buf and converted in place, so arrays of any size are read without extra
+ * copies or allocation.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 8 bytes per value frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param int_buf Pointer to the beginning of an array of uint64_t.
+ * @param int_count The number of values to attempt reading <= array length.
+ * @return The number of values read from the serial port.
+ * @since 0.2
+ */
+int ino_read_uint64s(ino_connection_t *cnx, uint64_t *int_buf, int int_count);
+
+/**
+ * Read multiple IEEE-754 single precision floats from an Arduino raw connection at once.
+ * Reads 4 bytes per value from the serial port and converts them from network
+ * byte order into host byte order.  The bytes are received directly into
+ * buf and converted in place, so arrays of any size are read without extra
+ * copies or allocation.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 4 bytes per value frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param buf Pointer to the beginning of an array of float.
+ * @param count The number of values to attempt reading <= array length.
+ * @return The number of values read from the serial port.
+ * @since 0.2
+ */
+int ino_read_floats(ino_connection_t *cnx, float *buf, int count);
+
+/**
+ * Read multiple IEEE-754 double precision floats from an Arduino raw connection at once.
+ * Reads 8 bytes per value from the serial port and converts them from network
+ * byte order into host byte order.  The bytes are received directly into
+ * buf and converted in place, so arrays of any size are read without extra
+ * copies or allocation.  The function requires an ino_connection_t object
+ * created using ino_connection_raw() with a 8 bytes per value frame size.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param buf Pointer to the beginning of an array of double.
+ * @param count The number of values to attempt reading <= array length.
+ * @return The number of values read from the serial port.
+ * @since 0.2
+ */
+int ino_read_doubles(ino_connection_t *cnx, double *buf, int count);
+
+/**
+ * Read multiple signed 16-bit integers sent as a delta stream.
+ * The Arduino library function ino_send_delta_int16s() sends each integer as
+ * its difference from the previous one, zigzag mapped and written as a
+ * varint of 7 bits per byte, so slowly changing sensor readings cost one
+ * byte each instead of two.  The differences are decoded straight out of the
+ * input buffer, which is refilled in the connection's read mode (see
+ * ino_set_read_exact()) until all integers have arrived.  As the stream's
+ * length depends on the data, the port must wake on every byte: use a raw
+ * connection in exact mode or with a frame size of 1, or a line-mode
+ * connection.  Other connections fail with errno set to EINVAL.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param int_buf Pointer to the beginning of an array of int16_t.
+ * @param int_count The number of integers to read.
+ * @return The number of integers read, or -1 on error or malformed data.
+ * @since 0.2
+ */
+int ino_read_delta_int16s(ino_connection_t *cnx, int16_t *int_buf, int int_count);
+
+/**
+ * Read multiple signed 32-bit integers sent as a delta stream.
+ * The Arduino library function ino_send_delta_int32s() sends each integer as
+ * its difference from the previous one, zigzag mapped and written as a
+ * varint of 7 bits per byte, so slowly changing readings cost one or two
+ * bytes each instead of four.  See ino_read_delta_int16s().
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param int_buf Pointer to the beginning of an array of int32_t.
+ * @param int_count The number of integers to read.
+ * @return The number of integers read, or -1 on error or malformed data.
+ * @since 0.2
+ */
+int ino_read_delta_int32s(ino_connection_t *cnx, int32_t *int_buf, int int_count);
+
+/**
+ * Decode an array of 16-bit samples sent as a delta stream.
+ * Use this on bytes that arrived by other means, e.g. as the payload of
+ * ino_read_frame() after the Arduino encoded them with
+ * ino_encode_delta_int16s().
+ * @param dst Destination for count samples.
+ * @param count The number of samples to decode.
+ * @param src Encoded bytes.
+ * @param nbytes Number of bytes in src.
+ * @return Number of bytes consumed, or -1 if src is malformed or too short.
+ * @since 0.2
+ */
+int ino_decode_delta_int16s(int16_t *dst, int count, const uint8_t *src, int nbytes);
+
+/**
+ * Decode an array of 32-bit samples sent as a delta stream.
+ * See ino_decode_delta_int16s().
+ * @param dst Destination for count samples.
+ * @param count The number of samples to decode.
+ * @param src Encoded bytes.
+ * @param nbytes Number of bytes in src.
+ * @return Number of bytes consumed, or -1 if src is malformed or too short.
+ * @since 0.2
+ */
+int ino_decode_delta_int32s(int32_t *dst, int count, const uint8_t *src, int nbytes);
+
+/**
+ * Read multiple unsigned integers bit-packed to a width below 16 bits.
+ * The Arduino library function ino_send_packed() sends only the low bits of
+ * each integer, back to back and most significant bit first, so four 10-bit
+ * ADC readings take 5 bytes instead of 8, and two 12-bit readings 3 bytes
+ * instead of 4.  INO_PACKED_SIZE(count, bits) bytes are read in the
+ * connection's read mode (see ino_set_read_exact()) and unpacked into buf.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param buf Pointer to the beginning of an array of uint16_t.
+ * @param count The number of integers to read.
+ * @param bits Width of each integer, 1 to 16.
+ * @return The number of integers read, or -1 on error.
+ * @since 0.2
+ */
+int ino_read_packed(ino_connection_t *cnx, uint16_t *buf, int count, int bits);
+
+/**
+ * Unpack unsigned integers bit-packed to a width below 16 bits.
+ * Use this on bytes that arrived by other means, e.g. as the payload of
+ * ino_read_frame() after the Arduino packed them with ino_pack_uint16s().
+ * Each integer is extracted with a single unaligned 64-bit load and two
+ * shifts, whatever its width.
+ * @param dst Destination for count integers.
+ * @param count The number of integers to unpack.
+ * @param src Packed bytes, the first integer in the most significant bits.
+ * @param nbytes Number of bytes in src.
+ * @param bits Width of each integer, 1 to 16.
+ * @return Number of bytes consumed, or -1 if bits is out of range or src is too short.
+ * @since 0.2
+ */
+int ino_unpack_uint16s(uint16_t *dst, int count, const uint8_t *src, int nbytes, int bits);
+
+/**
+ * Convert an array of big endian 16-bit integers into host byte order.
+ * Works on bytes already in memory, e.g. a captured stream being replayed,
+ * and uses SSSE3/AVX2 or NEON byte shuffles when the CPU supports them.
+ * @param dst Destination array of count uint16_t, may be the same memory as src.
+ * @param src Source bytes, 2 per integer, in network byte order.
+ * @param count The number of integers to convert.
+ * @since 0.2
+ */
+void ino_betoh16s(uint16_t *dst, const uint8_t *src, int count);
+
+/**
+ * Convert an array of big endian 32-bit integers into host byte order.
+ * Works on bytes already in memory, e.g. a captured stream being replayed,
+ * and uses SSSE3/AVX2 or NEON byte shuffles when the CPU supports them.
+ * @param dst Destination array of count uint32_t, may be the same memory as src.
+ * @param src Source bytes, 4 per integer, in network byte order.
+ * @param count The number of integers to convert.
+ * @since 0.2
+ */
+void ino_betoh32s(uint32_t *dst, const uint8_t *src, int count);
+
+/**
+ * Convert an array of big endian 64-bit integers into host byte order.
+ * Works on bytes already in memory, e.g. a captured stream being replayed,
+ * and uses SSSE3/AVX2 or NEON byte shuffles when the CPU supports them.
+ * @param dst Destination array of count uint64_t, may be the same memory as src.
+ * @param src Source bytes, 8 per integer, in network byte order.
+ * @param count The number of integers to convert.
+ * @since 0.2
+ */
+void ino_betoh64s(uint64_t *dst, const uint8_t *src, int count);
+
+/**
+ * Convert an array of host 16-bit integers into big endian bytes.
+ * The inverse of ino_betoh16s().
+ * @param dst Destination bytes, 2 per integer, may be the same memory as src.
+ * @param src Source array of count uint16_t in host byte order.
+ * @param count The number of integers to convert.
+ * @since 0.2
+ */
+void ino_htobe16s(uint8_t *dst, const uint16_t *src, int count);
+
+/**
+ * Convert an array of host 32-bit integers into big endian bytes.
+ * The inverse of ino_betoh32s().
+ * @param dst Destination bytes, 4 per integer, may be the same memory as src.
+ * @param src Source array of count uint32_t in host byte order.
+ * @param count The number of integers to convert.
+ * @since 0.2
+ */
+void ino_htobe32s(uint8_t *dst, const uint32_t *src, int count);
+
+/**
+ * Convert an array of host 64-bit integers into big endian bytes.
+ * The inverse of ino_betoh64s().
+ * @param dst Destination bytes, 8 per integer, may be the same memory as src.
+ * @param src Source array of count uint64_t in host byte order.
+ * @param count The number of integers to convert.
+ * @since 0.2
+ */
+void ino_htobe64s(uint8_t *dst, const uint64_t *src, int count);
+
 /**
  * Send an array of raw bytes to the Arduino through the serial port.
  * Sends an array of uint8_t through the given ino_connection_t/serial port.
@@ -470,6 +1307,168 @@ int ino_send_int32(ino_connection_t *cnx, int32_t val);
  */
 int ino_send_uint32(ino_connection_t *cnx, uint32_t val);
 
+/**
+ * Send multiple signed 16-bit integers to the Arduino at once.
+ * Converts each int16_t to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 2 bytes per integer.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param int_buf Pointer to the beginning of an array of int16_t.
+ * @param int_count The number of integers to send.
+ * @return The number of integers sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_send_int16s(ino_connection_t *cnx, const int16_t *int_buf, int int_count);
+
+/**
+ * Send multiple unsigned 16-bit integers to the Arduino at once.
+ * Converts each uint16_t to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 2 bytes per integer.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param int_buf Pointer to the beginning of an array of uint16_t.
+ * @param int_count The number of integers to send.
+ * @return The number of integers sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_send_uint16s(ino_connection_t *cnx, const uint16_t *int_buf, int int_count);
+
+/**
+ * Send multiple signed 32-bit integers to the Arduino at once.
+ * Converts each int32_t to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 4 bytes per integer.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param int_buf Pointer to the beginning of an array of int32_t.
+ * @param int_count The number of integers to send.
+ * @return The number of integers sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_send_int32s(ino_connection_t *cnx, const int32_t *int_buf, int int_count);
+
+/**
+ * Send multiple unsigned 32-bit integers to the Arduino at once.
+ * Converts each uint32_t to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 4 bytes per integer.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param int_buf Pointer to the beginning of an array of uint32_t.
+ * @param int_count The number of integers to send.
+ * @return The number of integers sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_send_uint32s(ino_connection_t *cnx, const uint32_t *int_buf, int int_count);
+
+/**
+ * Send a single signed 64-bit integer to the Arduino through the serial port.
+ * Converts an int64_t to network byte order and sends it byte by byte through
+ * the given serial port connection to the Arduino on the other end.  Network
+ * byte order raw integers can be read by the Arduino using the corresponding
+ * "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param val int64_t to be sent to Arduino.
+ * @return The number of bytes actually sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_send_int64(ino_connection_t *cnx, int64_t val);
+
+/**
+ * Send a single unsigned 64-bit integer to the Arduino through the serial port.
+ * Converts a uint64_t to network byte order and sends it byte by byte through
+ * the given serial port connection to the Arduino on the other end.  Network
+ * byte order raw integers can be read by the Arduino using the corresponding
+ * "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param val uint64_t to be sent to Arduino.
+ * @return The number of bytes actually sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_send_uint64(ino_connection_t *cnx, uint64_t val);
+
+/**
+ * Send a single IEEE-754 single precision float to the Arduino through the serial port.
+ * Sends the 4 byte binary32 encoding of the value in network byte order,
+ * which the Arduino can read with the corresponding "read" function in the
+ * Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param val float to be sent to Arduino.
+ * @return The number of bytes actually sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_send_float(ino_connection_t *cnx, float val);
+
+/**
+ * Send a single IEEE-754 double precision float to the Arduino through the serial port.
+ * Sends the 8 byte binary64 encoding of the value in network byte order,
+ * which the Arduino can read with the corresponding "read" function in the
+ * Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param val double to be sent to Arduino.
+ * @return The number of bytes actually sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_send_double(ino_connection_t *cnx, double val);
+
+/**
+ * Send multiple signed 64-bit integers to the Arduino at once.
+ * Converts each value to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 8 bytes per value.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param int_buf Pointer to the beginning of an array of int64_t.
+ * @param int_count The number of values to send.
+ * @return The number of values sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_send_int64s(ino_connection_t *cnx, const int64_t *int_buf, int int_count);
+
+/**
+ * Send multiple unsigned 64-bit integers to the Arduino at once.
+ * Converts each value to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 8 bytes per value.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param int_buf Pointer to the beginning of an array of uint64_t.
+ * @param int_count The number of values to send.
+ * @return The number of values sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_send_uint64s(ino_connection_t *cnx, const uint64_t *int_buf, int int_count);
+
+/**
+ * Send multiple IEEE-754 single precision floats to the Arduino at once.
+ * Converts each value to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 4 bytes per value.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param buf Pointer to the beginning of an array of float.
+ * @param count The number of values to send.
+ * @return The number of values sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_send_floats(ino_connection_t *cnx, const float *buf, int count);
+
+/**
+ * Send multiple IEEE-754 double precision floats to the Arduino at once.
+ * Converts each value to network byte order into one contiguous buffer and sends
+ * the whole array through the given serial port connection with a single
+ * write, 8 bytes per value.  The Arduino can read them with the
+ * corresponding "read" function in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param buf Pointer to the beginning of an array of double.
+ * @param count The number of values to send.
+ * @return The number of values sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_send_doubles(ino_connection_t *cnx, const double *buf, int count);
+
 /**
  * Send a single char through the serial port.
  * Sends a single character through the serial port to the Arduino.  This is just
@@ -483,4 +1482,386 @@ int ino_send_uint32(ino_connection_t *cnx, uint32_t val);
  */
  int ino_send_char(ino_connection_t *cnx, char c);
 
+/**
+ * Update a CRC-16/CCITT checksum (polynomial 0x1021, MSB first) with more bytes.
+ * Pass INO_CRC16_INIT with the first bytes and the previous return value with
+ * each further piece, so a frame can be checked while it streams in.  Gives
+ * the same result as ino_crc16() in the Arduino library, arduino_libuino.h,
+ * and is the checksum carried by ino_send_frame().
+ * @param crc INO_CRC16_INIT for the first bytes, or the previous return value.
+ * @param buf Next bytes.
+ * @param nbytes Number of bytes in buf.
+ * @return CRC of all bytes so far.
+ * @since 0.2
+ */
+uint16_t ino_crc16(uint16_t crc, const uint8_t *buf, int nbytes);
+
+/**
+ * Update a CRC32C (Castagnoli) checksum with more bytes.
+ * Pass INO_CRC32C_INIT with the first bytes and the previous return value with
+ * each further piece.  Uses the SSE4.2 or ARMv8 crc32c instructions when the
+ * CPU supports them, which check gigabytes per second, and a table otherwise.
+ * @param crc INO_CRC32C_INIT for the first bytes, or the previous return value.
+ * @param buf Next bytes.
+ * @param nbytes Number of bytes in buf.
+ * @return CRC of all bytes so far.
+ * @since 0.2
+ */
+uint32_t ino_crc32c(uint32_t crc, const uint8_t *buf, int nbytes);
+
+/**
+ * Send a frame of bytes to the Arduino with framing and a checksum.
+ * Unlike ino_send_raw(), the frame boundaries survive lost or corrupted bytes.
+ * The frame goes out as an INO_FRAME_END byte, the 16-bit payload length, the
+ * payload and a CRC-16/CCITT of length and payload, both fields in network
+ * byte order, SLIP-escaped so that INO_FRAME_END only occurs between frames,
+ * followed by another INO_FRAME_END byte.  The Arduino can read it with
+ * ino_read_frame() in the Arduino library, arduino_libuino.h .
+ * @param cnx Pointer to ino_connection_t object through which to send data.
+ * @param buf Payload to send.
+ * @param nbytes Number of payload bytes, 1 to INO_MAX_FRAME_SIZE.
+ * @return The number of payload bytes sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_send_frame(ino_connection_t *cnx, const uint8_t *buf, int nbytes);
+
+/**
+ * Read the next valid frame sent by ino_send_frame() in the Arduino library.
+ * Frames are found by their end bytes and checked against their length and
+ * CRC.  A frame that was damaged in transit, an empty one, which neither side
+ * sends, or one larger than max_bytes, is dropped and counted in the
+ * connection's frame_errors, and reading resynchronizes at the next end byte.  A dropped byte therefore costs a
+ * single frame rather than the alignment of everything that follows.  Frames
+ * share the connection's input buffer with the other raw read functions but
+ * should not be mixed with them on the same stream.  As frames vary in
+ * length, the port must wake on every byte: use a raw connection in exact
+ * mode, see ino_set_read_exact(), or with a frame size of 1, or a line-mode
+ * connection.  Other connections are rejected with errno set to EINVAL, as
+ * a port waiting for raw_size bytes could hold a frame back indefinitely.
+ * @param cnx Pointer to ino_connection_t object from which to read data.
+ * @param buf Destination for the payload.
+ * @param max_bytes Capacity of buf.
+ * @param timeout_us Microseconds to wait for a valid frame, or INO_NO_TIMEOUT.
+ * @return Payload size, 0 on timeout or hang up, or -1 on error.
+ * @since 0.2
+ */
+int ino_read_frame(ino_connection_t *cnx, uint8_t *buf, int max_bytes, long timeout_us);
+
+/**
+ * Hold the output of ino_send_*() calls in the connection's transmit buffer.
+ * A command made of several fields then goes out in a single write(), and
+ * usually a single USB packet, when ino_flush() or ino_uncork() is called,
+ * when the buffer fills, or when ino_set_autoflush() limits are reached.
+ * Connections attached to an io_uring engine already batch their output, so
+ * corking has no further effect on them.
+ * @param cnx Pointer to ino_connection_t object to cork.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int ino_cork(ino_connection_t *cnx);
+
+/**
+ * Send all output held in the connection's transmit buffer.
+ * The connection stays corked.  Bytes a failed write left behind stay held
+ * and go out with the next flush or send.
+ * @param cnx Pointer to ino_connection_t object to flush.
+ * @return The number of bytes sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_flush(ino_connection_t *cnx);
+
+/**
+ * Send all held output and stop holding the output of later sends.
+ * @param cnx Pointer to ino_connection_t object to uncork.
+ * @return The number of bytes sent, or -1 on error.
+ * @since 0.2
+ */
+int ino_uncork(ino_connection_t *cnx);
+
+/**
+ * Set when corked output is flushed without an explicit ino_flush().
+ * Output is flushed by the send that brings the waiting bytes to
+ * threshold_bytes, and by the first send made delay_us microseconds or more
+ * after the oldest waiting byte was corked.  Either limit may be zero to
+ * disable it.  The deadline is only checked when sending, so call
+ * ino_flush() before going idle.
+ * @param cnx Pointer to ino_connection_t object to configure.
+ * @param threshold_bytes Waiting bytes that trigger a flush, or 0.
+ * @param delay_us Microseconds output may wait before a send flushes it, or 0.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int ino_set_autoflush(ino_connection_t *cnx, int threshold_bytes, long delay_us);
+
+/**
+ * Start a background reader thread on an open raw connection.
+ * The thread reads raw_size byte frames from the port as fast as they arrive
+ * and publishes them into a lock-free queue holding at least nframes frames,
+ * from which the application takes them with ino_reader_pop() without any
+ * syscalls or locks.  A slow application therefore never stalls the port;
+ * if the queue fills up, new frames are dropped and counted in the reader's
+ * dropped field rather than left to overflow the kernel buffer.  While the
+ * reader runs, no other read function may be used on the connection.
+ * @param cnx Pointer to an open ino_connection_t object created with ino_connection_raw().
+ * @param nframes Minimum number of frames the queue should hold.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int ino_reader_start(ino_connection_t *cnx, int nframes);
+
+/**
+ * Take the oldest frame from a connection's background reader queue.
+ * Never blocks and makes no syscalls.
+ * @param cnx Pointer to ino_connection_t object with a running reader.
+ * @param buf Pointer to an array of at least raw_size uint8_t.
+ * @return raw_size if a frame was copied, 0 if the queue is empty, or -1
+ * if the queue is empty and the reader has stopped after a hang up or error.
+ * @since 0.2
+ */
+int ino_reader_pop(ino_connection_t *cnx, uint8_t *buf);
+
+/**
+ * Stop a connection's background reader thread and free its queue.
+ * Frames still queued are discarded.  Called automatically by ino_close().
+ * If the thread cannot be woken or joined the queue is left in place, since
+ * the thread may still be using it, and the call may be repeated.
+ * @param cnx Pointer to ino_connection_t object with a running reader.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int ino_reader_stop(ino_connection_t *cnx);
+
+#ifdef __linux__
+/**
+ * Create a new reactor for servicing many Arduino connections from one thread.
+ * Register open connections with ino_poller_add() and call ino_poller_wait()
+ * in a loop.  Each time a port becomes readable the poller drains it into the
+ * connection's input buffer and hands every complete frame to the connection's
+ * callback: raw_size bytes at a time for raw connections, or one line at a
+ * time for character connections.  Must be freed with ino_poller_destroy().
+ * @return Pointer to new ino_poller_t object, or NULL on error.
+ * @since 0.2
+ */
+ino_poller_t *ino_poller_new(void);
+
+/**
+ * Free a reactor created with ino_poller_new().
+ * Registered connections are left open and must be destroyed separately.
+ * @param poller Pointer to ino_poller_t object to be destroyed.
+ * @since 0.2
+ */
+void ino_poller_destroy(ino_poller_t *poller);
+
+/**
+ * Register an open connection and its frame callback with a reactor.
+ * The port is switched to non-blocking mode.  Closing the connection with
+ * ino_close() removes it from the poller automatically.
+ * @param poller Pointer to ino_poller_t object.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @param cb Function called with each complete frame.
+ * @param arg User argument passed to cb.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int ino_poller_add(ino_poller_t *poller, ino_connection_t *cnx, ino_frame_cb cb, void *arg);
+
+/**
+ * Remove a connection from a reactor without closing it.
+ * @param poller Pointer to ino_poller_t object.
+ * @param cnx Pointer to a registered ino_connection_t object.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int ino_poller_remove(ino_poller_t *poller, ino_connection_t *cnx);
+
+/**
+ * Wait for registered connections to become readable and dispatch their frames.
+ * Blocks up to timeout_ms milliseconds, or indefinitely if timeout_ms is -1,
+ * then services every ready connection, invoking its callback once per
+ * complete frame.  Partial frames stay buffered until the rest arrives.
+ * A connection that hangs up or fails is removed from the poller after its
+ * callback is told so.
+ * @param poller Pointer to ino_poller_t object.
+ * @param timeout_ms Milliseconds to wait, 0 to return immediately, -1 forever.
+ * @return The number of frames dispatched, or -1 on error.
+ * @since 0.2
+ */
+int ino_poller_wait(ino_poller_t *poller, int timeout_ms);
+
+/**
+ * Create a new io_uring I/O engine for many Arduino connections.
+ * Attach open connections with ino_uring_add() and call ino_uring_wait() in a
+ * loop.  The engine keeps a read posted on every attached port so input lands
+ * in the connection's input buffer without a read() per wakeup, and it
+ * collects the output of the ino_send_*() functions, submitting the writes of
+ * all connections together with a single syscall.  If the kernel lacks
+ * io_uring, or it has been disabled, NULL is returned and the application
+ * should keep using read()/write() through ino_poller_t and the ordinary
+ * read functions instead.  Must be freed with ino_uring_destroy().
+ * @param entries Submission queue size; at least two per connection is advised.
+ * @return Pointer to new ino_uring_t object, or NULL if io_uring is unavailable.
+ * @since 0.2
+ */
+ino_uring_t *ino_uring_new(unsigned entries);
+
+/**
+ * Free an io_uring engine created with ino_uring_new().
+ * Every attached connection is detached first, so all of them fall back to
+ * read()/write(); the connections themselves stay open.
+ * @param uring Pointer to ino_uring_t object to be destroyed.
+ * @since 0.2
+ */
+void ino_uring_destroy(ino_uring_t *uring);
+
+/**
+ * Attach an open connection and its frame callback to an io_uring engine.
+ * From then on the connection's input is only delivered through cb, in the
+ * same way as for ino_poller_add(), and ino_send_*() output is queued for
+ * the engine to submit on the next ino_uring_submit() or ino_uring_wait().
+ * Closing the connection with ino_close() detaches it automatically.
+ * @param uring Pointer to ino_uring_t object.
+ * @param cnx Pointer to an open ino_connection_t object.
+ * @param cb Function called with each complete frame.
+ * @param arg User argument passed to cb.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int ino_uring_add(ino_uring_t *uring, ino_connection_t *cnx, ino_frame_cb cb, void *arg);
+
+/**
+ * Detach a connection from its io_uring engine without closing it.
+ * Cancels the posted read and waits for the connection's outstanding requests
+ * to finish; queued output that was never submitted is sent with write().
+ * Other connections' frames may be dispatched while waiting.
+ * @param cnx Pointer to an attached ino_connection_t object.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int ino_uring_remove(ino_connection_t *cnx);
+
+/**
+ * Submit all queued writes and reads without waiting for any to complete.
+ * @param uring Pointer to ino_uring_t object.
+ * @return The number of requests submitted, or -1 on error.
+ * @since 0.2
+ */
+int ino_uring_submit(ino_uring_t *uring);
+
+/**
+ * Submit queued requests, wait for completions and dispatch incoming frames.
+ * Blocks up to timeout_ms milliseconds, or indefinitely if timeout_ms is -1,
+ * for at least one request to complete, then processes every completion:
+ * frames are handed to their connection's callback and reads are posted
+ * again.  A connection that hangs up or fails is told so through its
+ * callback and stays attached, idle, until it is removed or closed.
+ * @param uring Pointer to ino_uring_t object.
+ * @param timeout_ms Milliseconds to wait, 0 to return immediately, -1 forever.
+ * @return The number of frames dispatched, or -1 on error.
+ * @since 0.2
+ */
+int ino_uring_wait(ino_uring_t *uring, int timeout_ms);
+
+/**
+ * List the serial devices present.
+ * Without a directory every tty in /sys/class/tty that is backed by a device,
+ * other than legacy platform UARTs, is listed with its node in /dev, e.g.
+ * ttyACM0, ttyUSB0 or ttyAMA0.  USB devices are identified from sysfs by
+ * vendor id, product id and serial number.  With a directory, e.g.
+ * /dev/serial/by-id or a directory of symlinks to ptys, its entries that are
+ * serial devices or ptys are listed instead.  Ports are not opened, so no
+ * board is reset.
+ * @param dir Directory of device nodes, or NULL for the devices in sysfs.
+ * @param devs Array filled with the devices found.
+ * @param max_devs Capacity of devs.
+ * @return The number of devices stored in devs, or -1 on error.
+ * @since 0.2
+ */
+int ino_discover(const char *dir, ino_device_t *devs, int max_devs);
+
+/**
+ * Create a new watcher for serial devices coming and going in a directory.
+ * The directory is watched with inotify.  Attach connections with
+ * ino_watcher_attach() and call ino_watcher_wait() in a loop: whenever a
+ * device with an attached identity appears the connection is pointed at its
+ * node and opened, and whenever the node disappears the connection is
+ * closed, so a board that re-enumerates after a USB glitch is back as soon as
+ * its node is.  Boards that announce themselves with INO_CONNECT_HANDSHAKE
+ * come back fastest; several boards appearing together are opened together
+ * with ino_open_all().  The first ino_watcher_wait() reports the devices
+ * already present.  Must be freed with ino_watcher_destroy().
+ * @param dir Directory to watch, or NULL for /dev.
+ * @param cb Function called for each device added or removed, or NULL.
+ * @param arg User argument passed to cb.
+ * @return Pointer to new ino_watcher_t object, or NULL on error.
+ * @since 0.2
+ */
+ino_watcher_t *ino_watcher_new(const char *dir, ino_device_cb cb, void *arg);
+
+/**
+ * Free a watcher created with ino_watcher_new().
+ * Attached connections are detached and left as they are; they must be
+ * destroyed separately.
+ * @param watcher Pointer to ino_watcher_t object to be destroyed.
+ * @since 0.2
+ */
+void ino_watcher_destroy(ino_watcher_t *watcher);
+
+/**
+ * Attach a connection to the device with the given identity.
+ * The connection's port is managed by the watcher from then on.  If the
+ * device is already present the connection is opened straight away, so
+ * the device callback may create and attach a connection for a device it
+ * is told about.  A connection can only be attached to one identity.
+ * @param watcher Pointer to ino_watcher_t object.
+ * @param id Stable identity of the device, see ino_device_t.
+ * @param cnx Pointer to ino_connection_t object to attach.
+ * @return -1 on error, including failing to open a device that is present,
+ *         and zero on success.
+ * @since 0.2
+ */
+int ino_watcher_attach(ino_watcher_t *watcher, const char *id, ino_connection_t *cnx);
+
+/**
+ * Detach a connection from a watcher without closing it.
+ * The port the connection had before it was attached is restored.
+ * @param watcher Pointer to ino_watcher_t object.
+ * @param cnx Pointer to an attached ino_connection_t object.
+ * @return -1 on error and zero on success.
+ * @since 0.2
+ */
+int ino_watcher_detach(ino_watcher_t *watcher, ino_connection_t *cnx);
+
+/**
+ * Get the descriptor that becomes readable when the watched directory changes.
+ * Add it to an event loop, e.g. epoll, and call ino_watcher_wait() with a
+ * zero timeout when it is readable.
+ * @param watcher Pointer to ino_watcher_t object.
+ * @return The inotify descriptor, or -1 on error.
+ * @since 0.2
+ */
+int ino_watcher_fd(ino_watcher_t *watcher);
+
+/**
+ * Wait for devices to come and go and open or close their connections.
+ * Blocks up to timeout_ms milliseconds, or indefinitely if timeout_ms is -1,
+ * for the directory to change, then opens the attached connections of the
+ * devices that appeared and closes those of the devices that disappeared.
+ * The callback is invoked for each with INO_DEVICE_ADDED or
+ * INO_DEVICE_REMOVED and the attached connection, or NULL if none is.
+ * Connections reopened this way must be registered again with any poller
+ * or io_uring engine they were on.  A connection that fails to open is
+ * retried when its node's attributes change, e.g. when udev sets its
+ * permissions.
+ * @param watcher Pointer to ino_watcher_t object.
+ * @param timeout_ms Milliseconds to wait, 0 to return immediately, -1 forever.
+ * @return The number of devices added or removed, or -1 on error.
+ * @since 0.2
+ */
+int ino_watcher_wait(ino_watcher_t *watcher, int timeout_ms);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -0,0 +1,572 @@
+/**
+ * @file				libuino.hpp
+ * @version		0.2
+ * @author			Julian White
+ * @copyright	August 26, 2013 by Julian White
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details at
+ * http://www.gnu.org/licenses/lgpl.html
+ *
+ * @section DESCRIPTION
+ *
+ * C++17 companion header to libuino.h.  It describes the layout of a raw
+ * frame as a type, so the frame size no longer has to be worked out by
+ * hand and the decoder and encoder are generated by the compiler:
+ *
+ *   using sample = ino::frame<int16_t, uint32_t, float>;
+ *
+ *   cnx = sample::connection(port, B9600, INO_DEFAULT_WAIT, INO_NO_TIMEOUT);
+ *   ino_open(cnx);
+ *   sample::tuple_type s;
+ *   if ( sample::read(cnx, s) > 0 ) printf("%d\n", std::get<0>(s));
+ *
+ * Fields are any integer type, float, double, or a std::array of those,
+ * and travel in network byte order (i.e., big endian) exactly as the
+ * arduino_libuino "send" functions write them.  sample::size is a
+ * constant expression, every field offset is fixed at compile time, and
+ * decoding a frame compiles down to one load and byte swap per field.
+ * Buffers whose size is known at compile time are checked against the
+ * frame size with static_assert.
+ *
+ * ino::connection owns an ino_connection_t and closes it when destroyed.
+ * It is movable but not copyable, and offers typed read<T>()/send<T>()
+ * and, with C++20, std::span overloads for arrays:
+ *
+ *   ino::connection cnx = ino::connection::raw<sample>(port, B9600, INO_DEFAULT_WAIT, INO_NO_TIMEOUT);
+ *   cnx.open();
+ *   float f = cnx.read<float>();
+ *   cnx.send(std::span(samples));
+ */
+
+#ifndef LIBUINO_HPP
+#define LIBUINO_HPP
+
+#if __cplusplus < 201703L
+#error "libuino.hpp requires C++17"
+#endif
+
+/* LIBRARIES */
+#include "libuino.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#define INO_HAVE_SPAN 1
+#endif
+
+namespace ino {
+
+namespace detail {
+
+/**
+ * Unsigned integer type of the given size in bytes.
+ * @since 0.2
+ */
+template <std::size_t N> struct uint_of;
+template <> struct uint_of<1> { typedef uint8_t type; };
+template <> struct uint_of<2> { typedef uint16_t type; };
+template <> struct uint_of<4> { typedef uint32_t type; };
+template <> struct uint_of<8> { typedef uint64_t type; };
+
+/**
+ * Reverse the bytes of an unsigned integer.
+ * @since 0.2
+ */
+template <typename U>
+inline U bswap(U v) noexcept
+{
+	if constexpr ( sizeof(U) == 1 ) return v;
+	else if constexpr ( sizeof(U) == 2 ) return __builtin_bswap16(v);
+	else if constexpr ( sizeof(U) == 4 ) return __builtin_bswap32(v);
+	else return __builtin_bswap64(v);
+}
+
+/**
+ * Load a network byte order value of type T from unaligned memory.
+ * @since 0.2
+ */
+template <typename T>
+inline T load_be(const uint8_t *p) noexcept
+{
+	typename uint_of<sizeof(T)>::type u;
+	T val;
+
+	std::memcpy(&u, p, sizeof(u));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	u = bswap(u);
+#endif
+	std::memcpy(&val, &u, sizeof(val));
+
+	return val;
+}
+
+/**
+ * Store a value of type T to unaligned memory in network byte order.
+ * @since 0.2
+ */
+template <typename T>
+inline void store_be(uint8_t *p, T val) noexcept
+{
+	typename uint_of<sizeof(T)>::type u;
+
+	std::memcpy(&u, &val, sizeof(u));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	u = bswap(u);
+#endif
+	std::memcpy(p, &u, sizeof(u));
+}
+
+} /* namespace detail */
+
+/**
+ * Wire format of a single frame field.
+ * Defined for integer types, float, double, and std::array of those.  Using
+ * any other type in a frame is a compile time error.
+ * @since 0.2
+ */
+template <typename T, typename Enable = void>
+struct field
+{
+	static_assert(sizeof(T) == 0, "ino::frame fields must be integers, float, double, or std::array of those");
+};
+
+template <typename T>
+struct field<T, typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type>
+{
+	static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8,
+	              "ino::frame fields must be 1, 2, 4 or 8 bytes wide");
+	static_assert(!std::is_floating_point<T>::value || std::numeric_limits<T>::is_iec559,
+	              "ino::frame floating point fields must be IEEE-754");
+
+	static constexpr std::size_t size = sizeof(T);		/**< bytes on the wire */
+
+	static T decode(const uint8_t *p) noexcept { return detail::load_be<T>(p); }
+	static void encode(uint8_t *p, T val) noexcept { detail::store_be<T>(p, val); }
+};
+
+template <typename T, std::size_t N>
+struct field<std::array<T, N>, void>
+{
+	static constexpr std::size_t size = N * field<T>::size;		/**< bytes on the wire */
+
+	static std::array<T, N> decode(const uint8_t *p) noexcept
+	{
+		std::array<T, N> val;
+		for ( std::size_t j = 0; j < N; j++ ) val[j] = field<T>::decode(p + j * field<T>::size);
+		return val;
+	}
+
+	static void encode(uint8_t *p, const std::array<T, N> &val) noexcept
+	{
+		for ( std::size_t j = 0; j < N; j++ ) field<T>::encode(p + j * field<T>::size, val[j]);
+	}
+};
+
+/**
+ * A raw frame made of the given fields in order.
+ * The frame size and the offset of each field are constant expressions.
+ * decode() and encode() are expanded per field at compile time, with no
+ * loops or branches over the field list at run time.
+ * @since 0.2
+ */
+template <typename... Fields>
+struct frame
+{
+	static_assert(sizeof...(Fields) > 0, "ino::frame needs at least one field");
+
+	typedef std::tuple<Fields...> tuple_type;		/**< decoded frame */
+
+	static constexpr std::size_t count = sizeof...(Fields);								/**< number of fields */
+	static constexpr std::size_t size = ( field<Fields>::size + ... );		/**< bytes on the wire */
+	/** byte offset of each field */
+	static constexpr std::array<std::size_t, sizeof...(Fields)> offsets = [] {
+		std::array<std::size_t, sizeof...(Fields)> off{};
+		std::size_t sizes[] = { field<Fields>::size... };
+		std::size_t at = 0;
+		for ( std::size_t j = 0; j < sizeof...(Fields); j++ )
+		{
+			off[j] = at;
+			at += sizes[j];
+		}
+		return off;
+	}();
+
+	/**
+	 * Decode one field from a frame buffer.
+	 * @param buf Frame of at least size bytes.
+	 * @return The value of field I.
+	 */
+	template <std::size_t I>
+	static typename std::tuple_element<I, tuple_type>::type get(const uint8_t *buf) noexcept
+	{
+		return field<typename std::tuple_element<I, tuple_type>::type>::decode(buf + offsets[I]);
+	}
+
+	/**
+	 * Decode a frame buffer into a tuple.
+	 * @param buf Frame of at least size bytes.
+	 * @param out Tuple to receive the fields.
+	 */
+	static void decode(const uint8_t *buf, tuple_type &out) noexcept
+	{
+		decode_fields(buf, out, std::index_sequence_for<Fields...>());
+	}
+
+	/**
+	 * Decode a frame buffer into a tuple.
+	 * @param buf Frame of at least size bytes.
+	 * @return The decoded fields.
+	 */
+	static tuple_type decode(const uint8_t *buf) noexcept
+	{
+		tuple_type out;
+		decode(buf, out);
+		return out;
+	}
+
+	/**
+	 * Decode a frame held in an array whose size is checked at compile time.
+	 */
+	template <std::size_t N>
+	static tuple_type decode(const std::array<uint8_t, N> &buf) noexcept
+	{
+		static_assert(N == size, "buffer size does not match ino::frame size");
+		return decode(buf.data());
+	}
+
+	/**
+	 * Decode a frame buffer into an aggregate struct.
+	 * The struct's members are initialized from the fields in order, so the
+	 * struct must list members of the field types in the same order.
+	 * @param buf Frame of at least size bytes.
+	 * @return The struct built from the fields.
+	 */
+	template <typename Struct>
+	static Struct decode_as(const uint8_t *buf) noexcept
+	{
+		return decode_struct<Struct>(buf, std::index_sequence_for<Fields...>());
+	}
+
+	/**
+	 * Encode fields into a frame buffer.
+	 * @param buf Frame of at least size bytes.
+	 * @param vals One value per field.
+	 */
+	static void encode(uint8_t *buf, const Fields &... vals) noexcept
+	{
+		encode_fields(buf, std::forward_as_tuple(vals...), std::index_sequence_for<Fields...>());
+	}
+
+	/**
+	 * Encode a tuple into a frame buffer.
+	 * Also accepts std::tie() of a struct's members.
+	 * @param buf Frame of at least size bytes.
+	 * @param vals Tuple of one value per field.
+	 */
+	template <typename... Ts>
+	static void encode(uint8_t *buf, const std::tuple<Ts...> &vals) noexcept
+	{
+		static_assert(sizeof...(Ts) == sizeof...(Fields), "tuple does not match ino::frame fields");
+		encode_fields(buf, vals, std::index_sequence_for<Fields...>());
+	}
+
+	/**
+	 * Encode a tuple into an array whose size is checked at compile time.
+	 */
+	template <std::size_t N, typename... Ts>
+	static void encode(std::array<uint8_t, N> &buf, const std::tuple<Ts...> &vals) noexcept
+	{
+		static_assert(N == size, "buffer size does not match ino::frame size");
+		encode(buf.data(), vals);
+	}
+
+	/**
+	 * Read and decode one frame from a raw connection.
+	 * @param cnx Pointer to ino_connection_t object from which to read data.
+	 * @param out Tuple to receive the fields; untouched unless a whole frame arrives.
+	 * @return The number of bytes read, or -1 on error.
+	 */
+	static int read(ino_connection_t *cnx, tuple_type &out)
+	{
+		uint8_t buf[size];
+		int n = ino_read_raw(cnx, buf, (int)size);
+
+		if ( n == (int)size ) decode(buf, out);
+
+		return n;
+	}
+
+	/**
+	 * Encode and send one frame through a raw connection.
+	 * @param cnx Pointer to ino_connection_t object through which to send data.
+	 * @param vals One value per field.
+	 * @return The number of bytes sent, or -1 on error.
+	 */
+	static int send(ino_connection_t *cnx, const Fields &... vals)
+	{
+		uint8_t buf[size];
+
+		encode(buf, vals...);
+
+		return ino_send_raw(cnx, buf, (int)size);
+	}
+
+	/**
+	 * Create a raw connection sized for this frame.
+	 * Same as ino_connection_raw() with frame_size_bytes set to size.
+	 */
+	static ino_connection_t *connection(char *port, speed_t baud, int connect_wait, int read_timeout)
+	{
+		return ino_connection_raw(port, baud, connect_wait, (int)size, read_timeout);
+	}
+
+private:
+	template <std::size_t... I>
+	static void decode_fields(const uint8_t *buf, tuple_type &out, std::index_sequence<I...>) noexcept
+	{
+		((std::get<I>(out) = field<Fields>::decode(buf + offsets[I])), ...);
+	}
+
+	template <typename Struct, std::size_t... I>
+	static Struct decode_struct(const uint8_t *buf, std::index_sequence<I...>) noexcept
+	{
+		return Struct{ field<Fields>::decode(buf + offsets[I])... };
+	}
+
+	template <typename Tuple, std::size_t... I>
+	static void encode_fields(uint8_t *buf, const Tuple &vals, std::index_sequence<I...>) noexcept
+	{
+		(field<Fields>::encode(buf + offsets[I], std::get<I>(vals)), ...);
+	}
+};
+
+namespace detail {
+
+/**
+ * Maps a value type to the C functions that read and send it.
+ * @since 0.2
+ */
+template <typename T> struct io
+{
+	static_assert(sizeof(T) == 0, "ino::connection reads and sends 8, 16, 32 and 64-bit integers, float and double");
+};
+
+#define INO_IO(T, one, many) \
+template <> struct io<T> \
+{ \
+	static T read(ino_connection_t *cnx) { return ino_read_##one(cnx); } \
+	static int send(ino_connection_t *cnx, T val) { return ino_send_##one(cnx, val); } \
+	static int read(ino_connection_t *cnx, T *buf, int count) { return ino_read_##many(cnx, buf, count); } \
+	static int send(ino_connection_t *cnx, const T *buf, int count) { return ino_send_##many(cnx, buf, count); } \
+};
+INO_IO(int16_t, int16, int16s)
+INO_IO(uint16_t, uint16, uint16s)
+INO_IO(int32_t, int32, int32s)
+INO_IO(uint32_t, uint32, uint32s)
+INO_IO(int64_t, int64, int64s)
+INO_IO(uint64_t, uint64, uint64s)
+INO_IO(float, float, floats)
+INO_IO(double, double, doubles)
+#undef INO_IO
+
+template <> struct io<uint8_t>
+{
+	static uint8_t read(ino_connection_t *cnx) { uint8_t b = 0; ino_read_raw(cnx, &b, 1); return b; }
+	static int send(ino_connection_t *cnx, uint8_t val) { return ino_send_raw(cnx, &val, 1); }
+	static int read(ino_connection_t *cnx, uint8_t *buf, int count) { return ino_read_raw(cnx, buf, count); }
+	static int send(ino_connection_t *cnx, const uint8_t *buf, int count) { return ino_send_raw(cnx, const_cast<uint8_t *>(buf), count); }
+};
+
+template <> struct io<int8_t>
+{
+	static int8_t read(ino_connection_t *cnx) { return (int8_t)io<uint8_t>::read(cnx); }
+	static int send(ino_connection_t *cnx, int8_t val) { return io<uint8_t>::send(cnx, (uint8_t)val); }
+	static int read(ino_connection_t *cnx, int8_t *buf, int count) { return io<uint8_t>::read(cnx, (uint8_t *)buf, count); }
+	static int send(ino_connection_t *cnx, const int8_t *buf, int count) { return io<uint8_t>::send(cnx, (const uint8_t *)buf, count); }
+};
+
+} /* namespace detail */
+
+/**
+ * Owning handle for an ino_connection_t.
+ * The connection is closed and freed when the handle is destroyed.  Handles
+ * can be moved, e.g. into and around a std::vector, but not copied, so a
+ * port is never opened twice or leaked.  The port name is copied, so it
+ * does not need to outlive the handle.  The C API stays available through
+ * get() for anything not wrapped here.
+ * @since 0.2
+ */
+class connection
+{
+public:
+	/** An empty handle. */
+	connection() noexcept = default;
+
+	/** Take ownership of a connection made with the C API. */
+	explicit connection(ino_connection_t *cnx) noexcept : cnx_(cnx) {}
+
+	/**
+	 * Create a character-oriented connection, as ino_connection_new().
+	 * The handle is empty if the connection could not be allocated.
+	 */
+	static connection text(const char *port, speed_t baud, int connect_wait = INO_DEFAULT_WAIT)
+	{
+		connection c;
+		if ( c.copy_port(port) ) c.cnx_ = ino_connection_new(c.port_.get(), baud, connect_wait);
+		return c;
+	}
+
+	/**
+	 * Create a raw connection, as ino_connection_raw().
+	 * The handle is empty if the connection could not be allocated.
+	 */
+	static connection raw(const char *port, speed_t baud, int connect_wait, int frame_size_bytes, int read_timeout)
+	{
+		connection c;
+		if ( c.copy_port(port) ) c.cnx_ = ino_connection_raw(c.port_.get(), baud, connect_wait, frame_size_bytes, read_timeout);
+		return c;
+	}
+
+	/**
+	 * Create a raw connection sized for an ino::frame type.
+	 */
+	template <typename Frame>
+	static connection raw(const char *port, speed_t baud, int connect_wait, int read_timeout)
+	{
+		return raw(port, baud, connect_wait, (int)Frame::size, read_timeout);
+	}
+
+	connection(const connection &) = delete;
+	connection &operator=(const connection &) = delete;
+
+	connection(connection &&other) noexcept
+		: port_(std::move(other.port_)), cnx_(other.cnx_)
+	{
+		other.cnx_ = nullptr;
+	}
+
+	connection &operator=(connection &&other) noexcept
+	{
+		if ( this != &other )
+		{
+			reset();
+			port_ = std::move(other.port_);
+			cnx_ = other.cnx_;
+			other.cnx_ = nullptr;
+		}
+		return *this;
+	}
+
+	~connection() { reset(); }
+
+	/** The underlying C connection, still owned by this handle. */
+	ino_connection_t *get() const noexcept { return cnx_; }
+
+	/** True if the handle holds a connection, open or not. */
+	explicit operator bool() const noexcept { return cnx_ != nullptr; }
+
+	/** Close and free the connection, leaving the handle empty. */
+	void reset() noexcept
+	{
+		ino_connection_destroy(cnx_);
+		cnx_ = nullptr;
+		port_.reset();
+	}
+
+	int open() { return ino_open(cnx_); }
+	int close() { return ino_close(cnx_); }
+	bool is_open() const { return cnx_ && ino_is_open(cnx_); }
+	int fd() const noexcept { return cnx_ ? cnx_->fd : -1; }
+
+	/**
+	 * Read one value of type T in network byte order.
+	 * T may be any 8, 16, 32 or 64-bit integer, float or double.
+	 */
+	template <typename T>
+	T read() { return detail::io<T>::read(cnx_); }
+
+	/**
+	 * Send one value of type T in network byte order.
+	 * @return The number of bytes sent, or -1 on error.
+	 */
+	template <typename T>
+	int send(T val) { return detail::io<T>::send(cnx_, val); }
+
+	/**
+	 * Read up to count values into buf.
+	 * @return The number of values read.
+	 */
+	template <typename T>
+	int read(T *buf, int count) { return detail::io<T>::read(cnx_, buf, count); }
+
+	/**
+	 * Send count values from buf.
+	 * @return The number of values sent, or -1 on error.
+	 */
+	template <typename T>
+	int send(const T *buf, int count) { return detail::io<T>::send(cnx_, buf, count); }
+
+#ifdef INO_HAVE_SPAN
+	/**
+	 * Read up to buf.size() values into buf.
+	 * @return The number of values read.
+	 */
+	template <typename T, std::size_t N>
+	int read(std::span<T, N> buf) { return read(buf.data(), (int)buf.size()); }
+
+	/**
+	 * Send every value in buf.
+	 * @return The number of values sent, or -1 on error.
+	 */
+	template <typename T, std::size_t N>
+	int send(std::span<T, N> buf) { return send((const std::remove_const_t<T> *)buf.data(), (int)buf.size()); }
+#endif
+
+	/**
+	 * Read and decode one ino::frame.
+	 * @return The number of bytes read, or -1 on error.
+	 */
+	template <typename Frame>
+	int read_frame(typename Frame::tuple_type &out) { return Frame::read(cnx_, out); }
+
+	/**
+	 * Encode and send one ino::frame.
+	 * @return The number of bytes sent, or -1 on error.
+	 */
+	template <typename Frame, typename... Ts>
+	int send_frame(const Ts &... vals) { return Frame::send(cnx_, vals...); }
+
+private:
+	bool copy_port(const char *port)
+	{
+		std::size_t n = std::strlen(port) + 1;
+		port_.reset(new (std::nothrow) char[n]);
+		if ( port_ ) std::memcpy(port_.get(), port, n);
+		return port_ != nullptr;
+	}
+
+	std::unique_ptr<char[]> port_;		/**< owned copy of the port name */
+	ino_connection_t *cnx_ = nullptr;	/**< owned C connection */
+};
+
+} /* namespace ino */
+
+#endif